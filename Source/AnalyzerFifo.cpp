@@ -0,0 +1,62 @@
+/*
+  ==============================================================================
+
+    AnalyzerFifo.cpp
+    Created: 17 Oct 2026 7:09:26am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#include "AnalyzerFifo.h"
+
+AnalyzerFifo::AnalyzerFifo()
+    : buffer (2, capacity)
+{
+    buffer.clear();
+}
+
+template <typename SampleType>
+void AnalyzerFifo::pushSamples (const juce::dsp::AudioBlock<const SampleType>& block) noexcept
+{
+    if (block.getNumChannels() == 0)
+        return;
+
+    auto numSamples = juce::jmin ((int) block.getNumSamples(), fifo.getFreeSpace());
+    const auto scope = fifo.write (numSamples);
+
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        auto* source = block.getChannelPointer ((size_t) juce::jmin (channel, (int) block.getNumChannels() - 1));
+        auto* dest = buffer.getWritePointer (channel);
+
+        std::copy (source, source + scope.blockSize1, dest + scope.startIndex1);
+        std::copy (source + scope.blockSize1, source + scope.blockSize1 + scope.blockSize2, dest + scope.startIndex2);
+    }
+}
+
+void AnalyzerFifo::push (const juce::dsp::AudioBlock<const float>& block) noexcept
+{
+    pushSamples (block);
+}
+
+void AnalyzerFifo::push (const juce::dsp::AudioBlock<const double>& block) noexcept
+{
+    pushSamples (block);
+}
+
+int AnalyzerFifo::pull (float* dest, int maxSamples) noexcept
+{
+    const auto scope = fifo.read (juce::jmin (maxSamples, fifo.getNumReady()));
+
+    auto mix = [this, dest] (int start, int count, int offset)
+    {
+        juce::FloatVectorOperations::add (dest + offset, buffer.getReadPointer (0, start), buffer.getReadPointer (1, start), count);
+        juce::FloatVectorOperations::multiply (dest + offset, 0.5f, count);
+    };
+
+    if (scope.blockSize1 > 0)   mix (scope.startIndex1, scope.blockSize1, 0);
+    if (scope.blockSize2 > 0)   mix (scope.startIndex2, scope.blockSize2, scope.blockSize1);
+
+    return scope.blockSize1 + scope.blockSize2;
+}
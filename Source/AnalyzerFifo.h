@@ -0,0 +1,47 @@
+/*
+  ==============================================================================
+
+    AnalyzerFifo.h
+    Created: 17 Oct 2026 7:09:26am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Wait-free single-producer/single-consumer ring of audio for the spectrum
+    analyzer.
+
+    The audio thread copies the first two channels of each block in with
+    push(). If the ring is full the block is dropped, and the audio thread
+    never waits. The consumer pulls the data back out as a mono mix. Storage
+    is fixed at construction, so neither side ever reallocates under the other.
+*/
+class AnalyzerFifo
+{
+public:
+    static constexpr int capacity = 1 << 15;
+
+    AnalyzerFifo();
+
+    /** Audio thread. Just a copy per channel; mono input fills both slots. */
+    void push (const juce::dsp::AudioBlock<const float>& block) noexcept;
+    void push (const juce::dsp::AudioBlock<const double>& block) noexcept;
+
+    /** Consumer thread. Mixes up to maxSamples into dest and returns how many it read. */
+    int pull (float* dest, int maxSamples) noexcept;
+
+private:
+    template <typename SampleType>
+    void pushSamples (const juce::dsp::AudioBlock<const SampleType>& block) noexcept;
+
+    juce::AbstractFifo fifo { capacity };
+    juce::AudioBuffer<float> buffer;
+
+    JUCE_DECLARE_NON_COPYABLE (AnalyzerFifo)
+};
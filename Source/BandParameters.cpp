@@ -0,0 +1,54 @@
+/*
+  ==============================================================================
+
+    BandParameters.cpp
+    Created: 17 Oct 2026 7:14:19am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#include "BandParameters.h"
+
+BandParameters::BandParameters (juce::AudioProcessorValueTreeState& state)
+{
+    for (int band = 0; band < maxBands; ++band)
+    {
+        auto& a = atomics[(size_t) band];
+        a.type    = state.getRawParameterValue (getParameterID (band, "Type"));
+        a.freq    = state.getRawParameterValue (getParameterID (band, "Freq"));
+        a.gain    = state.getRawParameterValue (getParameterID (band, "Gain"));
+        a.quality = state.getRawParameterValue (getParameterID (band, "Quality"));
+
+        jassert (a.type != nullptr && a.freq != nullptr && a.gain != nullptr && a.quality != nullptr);
+    }
+}
+
+void BandParameters::addParameters (juce::AudioProcessorValueTreeState::ParameterLayout& layout)
+{
+    for (int band = 0; band < maxBands; ++band)
+    {
+        // Spread the default frequencies evenly over the audio range in octaves.
+        auto defaultFreq = std::round (20.f * std::pow (1000.f, (band + 0.5f) / (float) maxBands));
+
+        layout.add (std::make_unique<juce::AudioParameterChoice> (getParameterID (band, "Type"), getParameterID (band, "Type"), getTypeNames(), 0));
+        layout.add (std::make_unique<juce::AudioParameterFloat> (getParameterID (band, "Freq"), getParameterID (band, "Freq"), juce::NormalisableRange<float> (20.f, 20000.f, 1.f, 1.f), defaultFreq));
+        layout.add (std::make_unique<juce::AudioParameterFloat> (getParameterID (band, "Gain"), getParameterID (band, "Gain"), juce::NormalisableRange<float> (-24.f, 24.f, 0.5f, 1.f), 0.f));
+        layout.add (std::make_unique<juce::AudioParameterFloat> (getParameterID (band, "Quality"), getParameterID (band, "Quality"), juce::NormalisableRange<float> (0.1f, 10.f, 0.05f, 1.f), 1.f));
+    }
+}
+
+BandSet BandParameters::read() const noexcept
+{
+    BandSet bands;
+
+    for (size_t band = 0; band < bands.size(); ++band)
+    {
+        bands[band].type    = static_cast<BandType> ((int) atomics[band].type->load (std::memory_order_relaxed));
+        bands[band].freq    = atomics[band].freq->load (std::memory_order_relaxed);
+        bands[band].gain    = atomics[band].gain->load (std::memory_order_relaxed);
+        bands[band].quality = atomics[band].quality->load (std::memory_order_relaxed);
+    }
+
+    return bands;
+}
@@ -0,0 +1,46 @@
+/*
+  ==============================================================================
+
+    BandParameters.h
+    Created: 17 Oct 2026 7:14:19am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "BandSet.h"
+
+//==============================================================================
+/**
+    The Band<n>Type/Freq/Gain/Quality parameters of the parametric section.
+
+    read() is lock-free and safe from any thread.
+*/
+class BandParameters
+{
+public:
+    explicit BandParameters (juce::AudioProcessorValueTreeState& state);
+
+    static juce::StringArray getTypeNames()     { return { "Off", "Peak", "LowShelf", "HighShelf", "Notch", "BandPass" }; }
+    static juce::String getParameterID (int band, const char* field)    { return "Band" + juce::String (band + 1) + field; }
+
+    static void addParameters (juce::AudioProcessorValueTreeState::ParameterLayout& layout);
+
+    BandSet read() const noexcept;
+
+private:
+    struct BandAtomics
+    {
+        std::atomic<float>* type;
+        std::atomic<float>* freq;
+        std::atomic<float>* gain;
+        std::atomic<float>* quality;
+    };
+
+    std::array<BandAtomics, maxBands> atomics;
+
+    JUCE_DECLARE_NON_COPYABLE (BandParameters)
+};
@@ -0,0 +1,47 @@
+/*
+  ==============================================================================
+
+    BandSet.h
+    Created: 17 Oct 2026 7:14:19am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <cmath>
+
+enum BandType{
+  bandOff,
+  bandPeak,
+  bandLowShelf,
+  bandHighShelf,
+  bandNotch,
+  bandPass
+};
+/** One band of the parametric section, on top of the main peak. */
+struct EqBand{
+  BandType type {bandOff};
+  float freq {1000.f}, gain {0.f}, quality {1.f};
+
+  /** Off bands, and bells or shelves at 0 dB, are skipped entirely. */
+  bool isActive() const noexcept
+  {
+      if (type == bandOff)
+          return false;
+      if (type == bandNotch || type == bandPass)
+          return true;
+      return std::abs (gain) > 1.0e-3f;
+  }
+
+  bool operator== (const EqBand& other) const noexcept
+  {
+      return type == other.type && freq == other.freq && gain == other.gain && quality == other.quality;
+  }
+  bool operator!= (const EqBand& other) const noexcept { return ! operator== (other); }
+};
+
+static constexpr int maxBands = 16;
+using BandSet = std::array<EqBand, maxBands>;
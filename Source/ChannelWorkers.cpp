@@ -0,0 +1,270 @@
+/*
+  ==============================================================================
+
+    ChannelWorkers.cpp
+    Created: 17 Oct 2026 7:41:57am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#include "ChannelWorkers.h"
+
+#if JUCE_LINUX
+ #include <linux/futex.h>
+ #include <sys/syscall.h>
+ #include <unistd.h>
+ #include <climits>
+#elif JUCE_MAC || JUCE_IOS
+ #include <dispatch/dispatch.h>
+#elif JUCE_WINDOWS
+ #include <windows.h>
+#else
+ #include <semaphore.h>
+ #include <cerrno>
+#endif
+
+namespace
+{
+   #if JUCE_LINUX
+    // std::atomic<int> is a plain int underneath, which is what the futex calls want.
+    void futexWait (std::atomic<int>& word, int expected) noexcept
+    {
+        syscall (SYS_futex, reinterpret_cast<int*> (&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+    }
+
+    void futexWakeAll (std::atomic<int>& word) noexcept
+    {
+        syscall (SYS_futex, reinterpret_cast<int*> (&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+    }
+   #endif
+}
+
+//==============================================================================
+#if ! JUCE_LINUX
+/** A counting semaphore whose release() is safe on the audio thread: one
+    kernel call that never blocks or allocates. Being counted, a release that
+    lands just before the worker waits is not lost.
+*/
+class ChannelWorkers::Semaphore
+{
+public:
+   #if JUCE_MAC || JUCE_IOS
+    Semaphore()                         : handle (dispatch_semaphore_create (0)) {}
+    ~Semaphore()                        { dispatch_release (handle); }
+    void release() noexcept             { dispatch_semaphore_signal (handle); }
+    void wait() noexcept                { dispatch_semaphore_wait (handle, DISPATCH_TIME_FOREVER); }
+
+   private:
+    dispatch_semaphore_t handle;
+   #elif JUCE_WINDOWS
+    Semaphore()                         : handle (CreateSemaphoreW (nullptr, 0, LONG_MAX, nullptr)) {}
+    ~Semaphore()                        { CloseHandle (handle); }
+    void release() noexcept             { ReleaseSemaphore (handle, 1, nullptr); }
+    void wait() noexcept                { WaitForSingleObject (handle, INFINITE); }
+
+   private:
+    HANDLE handle;
+   #else
+    Semaphore()                         { sem_init (&handle, 0, 0); }
+    ~Semaphore()                        { sem_destroy (&handle); }
+    void release() noexcept             { sem_post (&handle); }
+    void wait() noexcept                { while (sem_wait (&handle) != 0 && errno == EINTR) {} }
+
+   private:
+    sem_t handle;
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE (Semaphore)
+};
+#endif
+
+//==============================================================================
+class ChannelWorkers::Worker  : public juce::Thread
+{
+public:
+    Worker (ChannelWorkers& o, int p)
+        : juce::Thread ("Vonic channel worker " + juce::String (p)), owner (o), participant (p)
+    {
+    }
+
+    void run() override
+    {
+        auto lastWork = juce::Time::getHighResolutionTicks();
+
+        while (! threadShouldExit())
+        {
+            if (owner.help (participant))
+                lastWork = juce::Time::getHighResolutionTicks();
+            else if (juce::Time::getHighResolutionTicks() - lastWork >= owner.spinTicks.load (std::memory_order_relaxed))
+            {
+                park();
+                lastWork = juce::Time::getHighResolutionTicks();
+            }
+        }
+    }
+
+private:
+    void park()
+    {
+        // Announce the sleep before reading the futex word, and look for work
+        // after it. A job published in between then either shows up here or
+        // bumps the word, so the wait returns at once.
+        owner.sleepers.fetch_add (1);
+        auto seen = owner.wakeups.load();
+
+        if (! threadShouldExit() && ! owner.hasWork())
+        {
+           #if JUCE_LINUX
+            futexWait (owner.wakeups, seen);
+           #else
+            juce::ignoreUnused (seen);
+            owner.semaphore->wait();
+           #endif
+        }
+
+        owner.sleepers.fetch_sub (1);
+    }
+
+    ChannelWorkers& owner;
+    const int participant;
+};
+
+//==============================================================================
+ChannelWorkers::ChannelWorkers()
+{
+   #if ! JUCE_LINUX
+    semaphore = std::make_unique<Semaphore>();
+   #endif
+}
+
+ChannelWorkers::~ChannelWorkers()
+{
+    stop();
+}
+
+void ChannelWorkers::setSpinTime (double seconds) noexcept
+{
+    spinTicks.store (juce::Time::secondsToHighResolutionTicks (seconds), std::memory_order_relaxed);
+}
+
+bool ChannelWorkers::start (int numWorkers)
+{
+    stop();
+
+    for (int i = 1; i <= juce::jmin (numWorkers, maxParticipants - 1); ++i)
+    {
+        auto* worker = workers.add (new Worker (*this, i));
+
+        // A preempted worker would stall the audio thread in the join, so
+        // without realtime scheduling it's better to run everything inline.
+        if (! worker->startRealtimeThread (juce::Thread::RealtimeOptions{}.withPriority (9)))
+        {
+            stop();
+            return false;
+        }
+    }
+
+    numRunning.store (workers.size());
+    return true;
+}
+
+void ChannelWorkers::stop()
+{
+    // A job that is already out still finishes; workers only leave between tasks.
+    numRunning.store (0);
+
+    for (auto* worker : workers)
+        worker->signalThreadShouldExit();
+
+    wake();
+
+    for (auto* worker : workers)
+        worker->stopThread (2000);
+
+    workers.clear();
+}
+
+void ChannelWorkers::wake() noexcept
+{
+    wakeups.fetch_add (1);
+
+   #if JUCE_LINUX
+    if (sleepers.load() > 0)
+        futexWakeAll (wakeups);
+   #else
+    // One release per parked worker. A worker that counted itself in but
+    // then found work, and never waited, just leaves a spare count behind;
+    // that costs it one extra trip round its spin loop later.
+    for (auto i = sleepers.load(); i > 0; --i)
+        semaphore->release();
+   #endif
+}
+
+void ChannelWorkers::run (int numTasks, Task task, void* context) noexcept
+{
+    jassert (numTasks >= 0 && numTasks <= 0xffff);
+
+    if (numRunning.load (std::memory_order_relaxed) == 0)
+    {
+        for (int i = 0; i < numTasks; ++i)
+            task (context, i, 0);
+
+        return;
+    }
+
+    auto generation = ((job.load (std::memory_order_relaxed) >> 32) + 1) & 0xffffffff;
+
+    jobTask.store (task, std::memory_order_relaxed);
+    jobContext.store (context, std::memory_order_relaxed);
+    tasksDone.store (0, std::memory_order_relaxed);
+    job.store (pack (generation, (juce::uint64) numTasks, 0), std::memory_order_release);
+
+    // A lock-free syscall, and only when a worker has actually parked.
+    wake();
+    help (0);
+
+    // Every task has been claimed; the only ones left are already running on a worker.
+    while (tasksDone.load (std::memory_order_acquire) < numTasks)
+    {
+    }
+}
+
+bool ChannelWorkers::hasWork() const noexcept
+{
+    auto current = job.load (std::memory_order_acquire);
+    return (current & 0xffff) < ((current >> 16) & 0xffff);
+}
+
+bool ChannelWorkers::help (int participant) noexcept
+{
+    auto ranAny = false;
+    auto current = job.load (std::memory_order_acquire);
+
+    for (;;)
+    {
+        auto numTasks = (current >> 16) & 0xffff;
+        auto next = current & 0xffff;
+
+        if (next >= numTasks)
+            return ranAny;
+
+        // Read before claiming. If a new job has replaced this one since, the
+        // claim fails and these are read again for the new job.
+        auto task = jobTask.load (std::memory_order_relaxed);
+        auto* context = jobContext.load (std::memory_order_relaxed);
+
+        if (job.compare_exchange_weak (current, current + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            {
+                // On the audio thread this is already set by processBlock's ScopedBlock.
+                const RealtimeMonitor::ScopedAudioThread critical (monitor);
+                task (context, (int) next, participant);
+            }
+
+            tasksDone.fetch_add (1, std::memory_order_release);
+            ranAny = true;
+            current = job.load (std::memory_order_acquire);
+        }
+    }
+}
@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+    ChannelWorkers.h
+    Created: 17 Oct 2026 7:41:57am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "RealtimeMonitor.h"
+
+//==============================================================================
+/**
+    A few helper threads that let one instance spread a block's channel
+    groups over several cores, for wide layouts like third-order ambisonics
+    or 9.1.6 beds.
+
+    run() is a fork/join. The audio thread publishes a job, and then works
+    through its tasks alongside any workers that are awake. A task is
+    claimed with a compare-and-swap on a single word that holds the job's
+    generation, its task count and the next free task. So a worker that
+    wakes late can never claim a task from a job that has already finished.
+
+    The audio thread never locks or sleeps. It claims whatever the workers
+    haven't taken, and at the end it only waits for tasks that are already
+    running on another core. If no worker is awake, it simply does the whole
+    job itself.
+
+    Between jobs a worker spins for a block period, so it is still awake
+    when the next block's job arrives; parking and waking every block would
+    cost more than a small job saves. After that it parks, on a futex on
+    Linux and a counting semaphore elsewhere. The audio thread only makes
+    the wake-up call when a worker is actually parked, so an instance that
+    isn't playing costs nothing.
+
+    While a worker runs a task it counts as audio-critical to the
+    RealtimeMonitor given to setMonitor(), the same as the audio thread
+    inside processBlock.
+
+    Workers have to run at realtime priority, since the join would stall on
+    a task whose worker got preempted. If any of them can't get it, none
+    are started and every job runs inline on the audio thread.
+*/
+class ChannelWorkers
+{
+public:
+    /** The audio thread plus up to three workers. */
+    static constexpr int maxParticipants = 4;
+
+    /** participant is 0 on the calling thread and 1.. on the workers, for per-thread scratch. */
+    using Task = void (*) (void* context, int taskIndex, int participant) noexcept;
+
+    ChannelWorkers();
+    ~ChannelWorkers();
+
+    /** Message thread. Starts numWorkers threads (at most maxParticipants - 1); zero just stops them.
+        Returns false if they couldn't get realtime priority, in which case none are left running.
+    */
+    bool start (int numWorkers);
+    void stop();
+
+    /** Any thread. How long an idle worker keeps looking for the next job before it parks;
+        normally the host's block period. */
+    void setSpinTime (double seconds) noexcept;
+
+    /** Message thread, before start(). Tasks on the workers are checked by this monitor. */
+    void setMonitor (RealtimeMonitor* newMonitor) noexcept  { monitor = newMonitor; }
+
+    /** Safe from any thread. Zero while the pool is stopped or being restarted. */
+    int getNumWorkers() const noexcept      { return numRunning.load (std::memory_order_relaxed); }
+
+    /** Audio thread. Runs task (context, 0 .. numTasks - 1, participant) and returns once every task has finished. */
+    void run (int numTasks, Task task, void* context) noexcept;
+
+private:
+    class Worker;
+    class Semaphore;
+
+    static constexpr juce::uint64 pack (juce::uint64 generation, juce::uint64 numTasks, juce::uint64 next) noexcept
+    {
+        return (generation << 32) | (numTasks << 16) | next;
+    }
+
+    /** Claims and runs tasks from the current job until none are left. Returns true if it ran any. */
+    bool help (int participant) noexcept;
+    bool hasWork() const noexcept;
+
+    /** Wakes any parked workers after a new job or a stop. */
+    void wake() noexcept;
+
+    alignas (64) std::atomic<juce::uint64> job { 0 };   // generation | numTasks | next task
+    std::atomic<Task> jobTask { nullptr };
+    std::atomic<void*> jobContext { nullptr };
+
+    alignas (64) std::atomic<int> tasksDone { 0 };
+
+    // The futex word parked workers wait on, and how many are parked.
+    alignas (64) std::atomic<int> wakeups { 0 };
+    std::atomic<int> sleepers { 0 };
+
+   #if ! JUCE_LINUX
+    std::unique_ptr<Semaphore> semaphore;
+   #endif
+
+    std::atomic<int> numRunning { 0 };
+    std::atomic<juce::int64> spinTicks { 0 };
+    RealtimeMonitor* monitor = nullptr;
+    juce::OwnedArray<Worker> workers;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ChannelWorkers)
+};
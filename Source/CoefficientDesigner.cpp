@@ -0,0 +1,311 @@
+/*
+  ==============================================================================
+
+    CoefficientDesigner.cpp
+    Created: 17 Oct 2026 6:56:07am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#include "CoefficientDesigner.h"
+
+namespace
+{
+    /** tan (pi y) for 0 < y <= 1/4, sampled at stepsPerOctave even steps in
+        each octave below 1/4. Everything is relative to the sample rate, so
+        one table serves every rate and oversampling factor. */
+    struct TanTable
+    {
+        static constexpr int numOctaves = 24, stepsPerOctave = 64;
+        std::array<std::array<double, stepsPerOctave + 1>, numOctaves> values;
+
+        TanTable()
+        {
+            for (int octave = 0; octave < numOctaves; ++octave)
+                for (int step = 0; step <= stepsPerOctave; ++step)
+                    values[(size_t) octave][(size_t) step] = std::tan (juce::MathConstants<double>::pi * getPoint (octave, step));
+        }
+
+        static double getPoint (int octave, int step) noexcept
+        {
+            return std::ldexp (0.5 + step / (2.0 * stepsPerOctave), -1 - octave);
+        }
+
+        double lookup (double y) const noexcept
+        {
+            // y = m 2^e with 0.5 <= m < 1, so the octave and the position in it
+            // come straight from the exponent and mantissa, with no log.
+            int exponent;
+            auto mantissa = std::frexp (y, &exponent);
+            auto octave = -1 - exponent;
+
+            if (octave >= numOctaves)
+                return juce::MathConstants<double>::pi * y;   // tan x == x to double precision down here
+
+            auto position = (mantissa - 0.5) * 2.0 * stepsPerOctave;
+            auto step = juce::jmin ((int) position, stepsPerOctave - 1);
+            auto& row = values[(size_t) juce::jmax (0, octave)];
+
+            return row[(size_t) step] + (position - step) * (row[(size_t) step + 1] - row[(size_t) step]);
+        }
+    };
+
+    const TanTable& getTanTable() noexcept
+    {
+        static const TanTable table;
+        return table;
+    }
+
+    /** 1/Q of each section of an order 2n Butterworth, by n - 1. */
+    using InverseQTable = std::array<std::array<double, CoefficientDesigner::maxCutSections>, CoefficientDesigner::maxCutSections>;
+
+    const InverseQTable& getButterworthInverseQ() noexcept
+    {
+        static const InverseQTable table = []
+        {
+            InverseQTable t {};
+
+            for (int numSections = 1; numSections <= CoefficientDesigner::maxCutSections; ++numSections)
+                for (int i = 0; i < numSections; ++i)
+                    t[(size_t) numSections - 1][(size_t) i] = 2.0 * std::cos ((2.0 * i + 1.0) * juce::MathConstants<double>::pi / (numSections * 4.0));
+
+            return t;
+        }();
+
+        return table;
+    }
+}
+
+//==============================================================================
+void CoefficientDesigner::prepare (double newSampleRate) noexcept
+{
+    sampleRate = newSampleRate;
+
+    // The shared tables are built on first use; make sure that happens here.
+    getTanTable();
+    getButterworthInverseQ();
+}
+
+double CoefficientDesigner::tanPi (double normalisedFrequency) noexcept
+{
+    // The table stops at a quarter of the sample rate. Above that,
+    // tan (pi y) = 1 / tan (pi (1/2 - y)), which keeps the relative error
+    // small right up to Nyquist, where tan itself blows up.
+    auto y = juce::jlimit (1.0e-12, 0.5 - 1.0e-12, normalisedFrequency);
+
+    if (y <= 0.25)
+        return getTanTable().lookup (y);
+
+    return 1.0 / getTanTable().lookup (0.5 - y);
+}
+
+void CoefficientDesigner::update (const FilterSet& settings, int stages) noexcept
+{
+    if (stages & peakStage)
+        designPeak (peak, sampleRate, settings.peakFreq, settings.peakQual, settings.peakGain);
+
+    if (stages & lowCutStage)
+        designButterworth (lowCut.data(), getNumSections (settings.lowCutSlope), sampleRate, settings.lowCutFreq, true);
+
+    if (stages & highCutStage)
+        designButterworth (highCut.data(), getNumSections (settings.highCutSlope), sampleRate, settings.highCutFreq, false);
+}
+
+void CoefficientDesigner::updateSvf (const FilterSet& settings, int stages) noexcept
+{
+    if (stages & peakStage)
+        designSvfPeak (svfPeak, sampleRate, settings.peakFreq, settings.peakQual, settings.peakGain);
+
+    if (stages & lowCutStage)
+        designSvfButterworth (svfLowCut.data(), getNumSections (settings.lowCutSlope), sampleRate, settings.lowCutFreq, true);
+
+    if (stages & highCutStage)
+        designSvfButterworth (svfHighCut.data(), getNumSections (settings.highCutSlope), sampleRate, settings.highCutFreq, false);
+}
+
+//==============================================================================
+void CoefficientDesigner::designPeak (BiquadCoefficients& dest, double sampleRate,
+                                      float frequency, float quality, float gainDecibels) noexcept
+{
+    // Same RBJ bell as IIR::Coefficients::makePeakFilter, minus the heap object.
+    auto A = std::sqrt (juce::jmax (0.0, (double) juce::Decibels::decibelsToGain (gainDecibels)));
+    auto omega = (juce::MathConstants<double>::twoPi * juce::jmax (frequency, 2.f)) / sampleRate;
+    auto alpha = std::sin (omega) / (2.0 * quality);
+    auto c2 = -2.0 * std::cos (omega);
+    auto alphaTimesA = alpha * A;
+    auto alphaOverA = alpha / A;
+    auto a0inv = 1.0 / (1.0 + alphaOverA);
+
+    dest.b0 = (1.0 + alphaTimesA) * a0inv;
+    dest.b1 = c2 * a0inv;
+    dest.b2 = (1.0 - alphaTimesA) * a0inv;
+    dest.a1 = c2 * a0inv;
+    dest.a2 = (1.0 - alphaOverA) * a0inv;
+}
+
+void CoefficientDesigner::designButterworth (BiquadCoefficients* dest, int numSections, double sampleRate,
+                                             float frequency, bool isHighPass) noexcept
+{
+    jassert (numSections > 0 && numSections <= maxCutSections);
+
+    // Same prewarp as makeHighPass / makeLowPass: tan for a high pass, its reciprocal
+    // for a low pass. Both that and the section Qs come from tables.
+    auto k = tanPi (juce::jlimit (2.0, sampleRate * 0.499, (double) frequency) / sampleRate);
+    auto n = isHighPass ? k : 1.0 / k;
+    auto nSquared = n * n;
+    auto& inverseQ = getButterworthInverseQ()[(size_t) numSections - 1];
+
+    for (int i = 0; i < numSections; ++i)
+    {
+        auto invQ = inverseQ[(size_t) i];
+        auto c1 = 1.0 / (1.0 + invQ * n + nSquared);
+
+        dest[i].b0 = c1;
+        dest[i].b1 = c1 * (isHighPass ? -2.0 : 2.0);
+        dest[i].b2 = c1;
+        dest[i].a1 = c1 * 2.0 * (isHighPass ? nSquared - 1.0 : 1.0 - nSquared);
+        dest[i].a2 = c1 * (1.0 - invQ * n + nSquared);
+    }
+}
+
+void CoefficientDesigner::designSvfPeak (SvfCoefficients& dest, double sampleRate,
+                                         float frequency, float quality, float gainDecibels) noexcept
+{
+    // Simper's bell: x + k (A^2 - 1) bandpass, with the damping divided by A
+    // so the poles match the RBJ bell that designPeak makes.
+    auto A = std::sqrt (juce::jmax (0.0, (double) juce::Decibels::decibelsToGain (gainDecibels)));
+
+    dest.g = tanPi (juce::jlimit (2.0, sampleRate * 0.499, (double) frequency) / sampleRate);
+    dest.k = 1.0 / (juce::jmax (0.01, (double) quality) * A);
+    dest.m0 = 1.0;
+    dest.m1 = dest.k * (A * A - 1.0);
+    dest.m2 = 0.0;
+}
+
+void CoefficientDesigner::designSvfButterworth (SvfCoefficients* dest, int numSections, double sampleRate,
+                                                float frequency, bool isHighPass) noexcept
+{
+    jassert (numSections > 0 && numSections <= maxCutSections);
+
+    // Every section shares the cutoff; only the damping differs. The high
+    // pass output is x - k bandpass - lowpass.
+    auto g = tanPi (juce::jlimit (2.0, sampleRate * 0.499, (double) frequency) / sampleRate);
+    auto& inverseQ = getButterworthInverseQ()[(size_t) numSections - 1];
+
+    for (int i = 0; i < numSections; ++i)
+    {
+        auto k = inverseQ[(size_t) i];
+
+        dest[i].g = g;
+        dest[i].k = k;
+        dest[i].m0 = isHighPass ? 1.0 : 0.0;
+        dest[i].m1 = isHighPass ? -k : 0.0;
+        dest[i].m2 = isHighPass ? -1.0 : 1.0;
+    }
+}
+
+void CoefficientDesigner::designBand (BiquadCoefficients& dest, double sampleRate, const EqBand& band) noexcept
+{
+    auto setNormalised = [&dest] (double b0, double b1, double b2, double a0, double a1, double a2)
+    {
+        auto a0inv = 1.0 / a0;
+        dest.b0 = b0 * a0inv;
+        dest.b1 = b1 * a0inv;
+        dest.b2 = b2 * a0inv;
+        dest.a1 = a1 * a0inv;
+        dest.a2 = a2 * a0inv;
+    };
+
+    auto frequency = juce::jlimit (2.0, sampleRate * 0.499, (double) band.freq);
+    auto quality = juce::jmax (0.01, (double) band.quality);
+
+    switch (band.type)
+    {
+        case bandPeak:
+            designPeak (dest, sampleRate, (float) frequency, (float) quality, band.gain);
+            break;
+
+        case bandLowShelf:
+        case bandHighShelf:
+        {
+            auto A = std::sqrt (juce::jmax (0.0, (double) juce::Decibels::decibelsToGain (band.gain)));
+            auto aminus1 = A - 1.0;
+            auto aplus1 = A + 1.0;
+            auto omega = (juce::MathConstants<double>::twoPi * frequency) / sampleRate;
+            auto coso = std::cos (omega);
+            auto beta = std::sin (omega) * std::sqrt (A) / quality;
+            auto aminus1TimesCoso = aminus1 * coso;
+
+            if (band.type == bandLowShelf)
+                setNormalised (A * (aplus1 - aminus1TimesCoso + beta),
+                               A * 2.0 * (aminus1 - aplus1 * coso),
+                               A * (aplus1 - aminus1TimesCoso - beta),
+                               aplus1 + aminus1TimesCoso + beta,
+                               -2.0 * (aminus1 + aplus1 * coso),
+                               aplus1 + aminus1TimesCoso - beta);
+            else
+                setNormalised (A * (aplus1 + aminus1TimesCoso + beta),
+                               A * -2.0 * (aminus1 + aplus1 * coso),
+                               A * (aplus1 + aminus1TimesCoso - beta),
+                               aplus1 - aminus1TimesCoso + beta,
+                               2.0 * (aminus1 - aplus1 * coso),
+                               aplus1 - aminus1TimesCoso - beta);
+            break;
+        }
+
+        case bandNotch:
+        case bandPass:
+        {
+            auto n = 1.0 / tanPi (frequency / sampleRate);
+            auto nSquared = n * n;
+            auto invQ = 1.0 / quality;
+            auto c1 = 1.0 / (1.0 + invQ * n + nSquared);
+
+            if (band.type == bandNotch)
+                setNormalised (c1 * (1.0 + nSquared), 2.0 * c1 * (1.0 - nSquared), c1 * (1.0 + nSquared),
+                               1.0, 2.0 * c1 * (1.0 - nSquared), c1 * (1.0 - invQ * n + nSquared));
+            else
+                setNormalised (c1 * n * invQ, 0.0, -c1 * n * invQ,
+                               1.0, 2.0 * c1 * (1.0 - nSquared), c1 * (1.0 - invQ * n + nSquared));
+            break;
+        }
+
+        case bandOff:
+        default:
+            dest = {};
+            break;
+    }
+}
+
+double CoefficientDesigner::getDecaySamples (const BiquadCoefficients& c, double decibels) noexcept
+{
+    // Pole radius of z^2 + a1 z + a2: sqrt (a2) for a complex pair,
+    // otherwise the larger of the two real roots.
+    auto discriminant = c.a1 * c.a1 - 4.0 * c.a2;
+    auto radius = discriminant < 0.0 ? std::sqrt (c.a2)
+                                     : 0.5 * (std::abs (c.a1) + std::sqrt (discriminant));
+
+    if (radius <= 0.0)
+        return 0.0;
+
+    if (radius >= 1.0)
+        return std::numeric_limits<double>::infinity();
+
+    return decibels / 20.0 * std::log (10.0) / -std::log (radius);
+}
+
+double CoefficientDesigner::getMagnitudeSquared (const BiquadCoefficients& c, double omega) noexcept
+{
+    auto cos1 = std::cos (omega);
+    auto cos2 = std::cos (2.0 * omega);
+
+    auto num = c.b0 * c.b0 + c.b1 * c.b1 + c.b2 * c.b2
+             + 2.0 * (c.b0 * c.b1 + c.b1 * c.b2) * cos1
+             + 2.0 * c.b0 * c.b2 * cos2;
+    auto den = 1.0 + c.a1 * c.a1 + c.a2 * c.a2
+             + 2.0 * (c.a1 + c.a1 * c.a2) * cos1
+             + 2.0 * c.a2 * cos2;
+
+    return num / juce::jmax (den, 1.0e-30);
+}
@@ -0,0 +1,106 @@
+/*
+  ==============================================================================
+
+    CoefficientDesigner.h
+    Created: 17 Oct 2026 6:56:07am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FilterSet.h"
+#include "BandSet.h"
+
+/** Normalised biquad coefficients, same layout as juce::dsp::IIR::Coefficients (a0 == 1).
+    Kept in double, so a chain running in double precision gets the full pole accuracy. */
+struct BiquadCoefficients
+{
+    double b0 {1.0}, b1 {0.0}, b2 {0.0}, a1 {0.0}, a2 {0.0};
+};
+
+/** One topology-preserving state-variable section: g = tan (pi fc / fs) and
+    k = 1 / Q set the poles, and the output is m0 x + m1 bandpass + m2 lowpass.
+    The defaults pass the signal straight through. */
+struct SvfCoefficients
+{
+    double g {0.0}, k {2.0}, m0 {1.0}, m1 {0.0}, m2 {0.0};
+};
+
+//==============================================================================
+/**
+    Designs the peak and Butterworth cut sections straight into fixed storage.
+
+    Nothing in here allocates, so it is safe to call from processBlock. update()
+    only redoes the maths for the stages it is told have changed. The cut
+    prewarp and section Qs come from tables built once, so a cutoff sweep
+    costs a table lookup and a little arithmetic per section.
+
+    The same stages can also be designed for the state-variable engine with
+    updateSvf(). There a cutoff change is just the one tan lookup, since g, k
+    and the output mix map straight onto frequency, Q and gain.
+*/
+class CoefficientDesigner
+{
+public:
+    static constexpr int maxCutSections = 4;
+    using CutSections = std::array<BiquadCoefficients, maxCutSections>;
+    using SvfCutSections = std::array<SvfCoefficients, maxCutSections>;
+
+    void prepare (double newSampleRate) noexcept;
+
+    /** Redesigns the stages set in the FilterStages mask. */
+    void update (const FilterSet& settings, int stages) noexcept;
+
+    const BiquadCoefficients& getPeak() const noexcept      { return peak; }
+    const CutSections& getLowCut() const noexcept           { return lowCut; }
+    const CutSections& getHighCut() const noexcept          { return highCut; }
+
+    /** Redesigns the stages set in the FilterStages mask for the state-variable engine. */
+    void updateSvf (const FilterSet& settings, int stages) noexcept;
+
+    const SvfCoefficients& getSvfPeak() const noexcept      { return svfPeak; }
+    const SvfCutSections& getSvfLowCut() const noexcept     { return svfLowCut; }
+    const SvfCutSections& getSvfHighCut() const noexcept    { return svfHighCut; }
+
+    static int getNumSections (Gradient slope) noexcept     { return static_cast<int> (slope) + 1; }
+
+    //==============================================================================
+    static void designPeak (BiquadCoefficients& dest, double sampleRate,
+                            float frequency, float quality, float gainDecibels) noexcept;
+
+    /** Butterworth cut of order 2 * numSections, matching FilterDesign's HighOrderButterworthMethod. */
+    static void designButterworth (BiquadCoefficients* dest, int numSections, double sampleRate,
+                                   float frequency, bool isHighPass) noexcept;
+
+    /** The same bell as designPeak, for the state-variable engine. */
+    static void designSvfPeak (SvfCoefficients& dest, double sampleRate,
+                               float frequency, float quality, float gainDecibels) noexcept;
+
+    /** The same Butterworth cut as designButterworth, for the state-variable engine. */
+    static void designSvfButterworth (SvfCoefficients* dest, int numSections, double sampleRate,
+                                      float frequency, bool isHighPass) noexcept;
+
+    /** Peak, shelf, notch or band-pass, matching the IIR::Coefficients factory of the same name. */
+    static void designBand (BiquadCoefficients& dest, double sampleRate, const EqBand& band) noexcept;
+
+    /** tan (pi f / sampleRate) from a lookup table, interpolated; for the bilinear prewarp. */
+    static double tanPi (double normalisedFrequency) noexcept;
+
+    /** Samples for the slower pole of a section to decay by the given number of decibels. */
+    static double getDecaySamples (const BiquadCoefficients& c, double decibels) noexcept;
+
+    /** |H|^2 of one section at omega = 2 pi f / sampleRate. */
+    static double getMagnitudeSquared (const BiquadCoefficients& c, double omega) noexcept;
+
+private:
+    double sampleRate = 44100.0;
+
+    BiquadCoefficients peak;
+    CutSections lowCut, highCut;
+
+    SvfCoefficients svfPeak;
+    SvfCutSections svfLowCut, svfHighCut;
+};
@@ -0,0 +1,32 @@
+/*
+  ==============================================================================
+
+    CoefficientHandover.cpp
+    Created: 17 Oct 2026 7:11:57am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#include "CoefficientHandover.h"
+
+void CoefficientHandover::post (const FilterSet& settings, const BandSet& bands, double sampleRate, juce::uint32 generation)
+{
+    handover.post ([&] (Prepared& slot)
+    {
+        designer.prepare (sampleRate);
+        designer.update (settings, allStages);
+
+        slot.settings = settings;
+        slot.sampleRate = sampleRate;
+        slot.peak = designer.getPeak();
+        slot.lowCut = designer.getLowCut();
+        slot.highCut = designer.getHighCut();
+        slot.bands = bands;
+        slot.generation = generation;
+
+        for (size_t band = 0; band < bands.size(); ++band)
+            if (bands[band].isActive())
+                CoefficientDesigner::designBand (slot.bandSections[band], sampleRate, bands[band]);
+    });
+}
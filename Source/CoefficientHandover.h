@@ -0,0 +1,46 @@
+/*
+  ==============================================================================
+
+    CoefficientHandover.h
+    Created: 17 Oct 2026 7:11:57am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "CoefficientDesigner.h"
+#include "RealtimeHandover.h"
+
+//==============================================================================
+/**
+    Passes a fully designed set of coefficients from a non-realtime thread to
+    the audio thread, e.g. when a preset or session is recalled. The
+    parametric bands come along, so they can fade in with everything else.
+*/
+class CoefficientHandover
+{
+public:
+    struct Prepared
+    {
+        FilterSet settings;
+        double sampleRate = 0.0;
+        BiquadCoefficients peak;
+        CoefficientDesigner::CutSections lowCut, highCut;
+        BandSet bands;
+        std::array<BiquadCoefficients, maxBands> bandSections;   // only the active bands are designed
+        juce::uint32 generation = 0;
+    };
+
+    /** Any thread but the audio one. Designs every stage and active band, replacing anything not yet fetched. */
+    void post (const FilterSet& settings, const BandSet& bands, double sampleRate, juce::uint32 generation);
+
+    /** Audio thread. Copies out a posted set, if there is one. */
+    bool fetch (Prepared& dest) noexcept        { return handover.fetch (dest); }
+
+private:
+    RealtimeHandover<Prepared> handover;
+    CoefficientDesigner designer;   // only touched inside post()
+};
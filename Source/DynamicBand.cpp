@@ -0,0 +1,142 @@
+/*
+  ==============================================================================
+
+    DynamicBand.cpp
+    Created: 17 Oct 2026 7:29:48am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#include "DynamicBand.h"
+
+DynamicBand::DynamicBand (juce::AudioProcessorValueTreeState& state)
+    : mode (state.getRawParameterValue ("Dynamic")),
+      detector (state.getRawParameterValue ("Detector")),
+      threshold (state.getRawParameterValue ("Threshold")),
+      ratio (state.getRawParameterValue ("Ratio")),
+      attack (state.getRawParameterValue ("Attack")),
+      release (state.getRawParameterValue ("Release"))
+{
+    jassert (mode != nullptr && detector != nullptr && threshold != nullptr
+             && ratio != nullptr && attack != nullptr && release != nullptr);
+}
+
+void DynamicBand::addParameters (juce::AudioProcessorValueTreeState::ParameterLayout& layout)
+{
+    layout.add (std::make_unique<juce::AudioParameterChoice> ("Dynamic", "Dynamic", juce::StringArray { "Static", "Dynamic" }, 0));
+    layout.add (std::make_unique<juce::AudioParameterChoice> ("Detector", "Detector", juce::StringArray { "Input", "Sidechain" }, 0));
+    layout.add (std::make_unique<juce::AudioParameterFloat> ("Threshold", "Threshold", juce::NormalisableRange<float> (-60.f, 0.f, 0.5f, 1.f), -24.f));
+    layout.add (std::make_unique<juce::AudioParameterFloat> ("Ratio", "Ratio", juce::NormalisableRange<float> (1.f, 20.f, 0.1f, 0.5f), 2.f));
+    layout.add (std::make_unique<juce::AudioParameterFloat> ("Attack", "Attack", juce::NormalisableRange<float> (0.1f, 200.f, 0.1f, 0.4f), 10.f));
+    layout.add (std::make_unique<juce::AudioParameterFloat> ("Release", "Release", juce::NormalisableRange<float> (5.f, 2000.f, 1.f, 0.4f), 150.f));
+}
+
+//==============================================================================
+void DynamicBand::prepare (double newSampleRate, int maximumBlockSize)
+{
+    sampleRate = newSampleRate;
+    envelope.assign ((size_t) maximumBlockSize, 0.0f);
+    designedFreq = designedQual = 0.0f;
+    reset();
+}
+
+void DynamicBand::reset() noexcept
+{
+    s1 = s2 = level = 0.0;
+    std::fill (envelope.begin(), envelope.end(), 0.0f);
+    numAnalysed = 0;
+}
+
+bool DynamicBand::update (float peakFreq, float peakQual) noexcept
+{
+    enabled = mode->load (std::memory_order_relaxed) > 0.5f;
+    useSidechain = detector->load (std::memory_order_relaxed) > 0.5f;
+
+    if (! enabled)
+        return false;
+
+    thresholdDecibels = threshold->load (std::memory_order_relaxed);
+    slope = 1.0f - 1.0f / juce::jmax (1.0f, ratio->load (std::memory_order_relaxed));
+
+    // One-pole time constants: the follower gets 63% of the way in the given time.
+    auto coefficientFor = [this] (float milliseconds)
+    {
+        return std::exp (-1.0 / (juce::jmax (0.01, (double) milliseconds) * 0.001 * sampleRate));
+    };
+
+    attackCoeff = coefficientFor (attack->load (std::memory_order_relaxed));
+    releaseCoeff = coefficientFor (release->load (std::memory_order_relaxed));
+
+    if (peakFreq != designedFreq || peakQual != designedQual)
+    {
+        EqBand band;
+        band.type = bandPass;
+        band.freq = peakFreq;
+        band.quality = peakQual;
+        CoefficientDesigner::designBand (detectorFilter, sampleRate, band);
+
+        designedFreq = peakFreq;
+        designedQual = peakQual;
+    }
+
+    return true;
+}
+
+void DynamicBand::analyse (const juce::dsp::AudioBlock<const float>& detection) noexcept
+{
+    analyseSamples (detection);
+}
+
+void DynamicBand::analyse (const juce::dsp::AudioBlock<const double>& detection) noexcept
+{
+    analyseSamples (detection);
+}
+
+template <typename SampleType>
+void DynamicBand::analyseSamples (const juce::dsp::AudioBlock<const SampleType>& detection) noexcept
+{
+    const auto numChannels = detection.getNumChannels();
+    numAnalysed = juce::jmin (detection.getNumSamples(), envelope.size());
+
+    if (numChannels == 0)
+    {
+        std::fill (envelope.begin(), envelope.begin() + (std::ptrdiff_t) numAnalysed, (float) level);
+        return;
+    }
+
+    const auto& c = detectorFilter;
+    const auto scale = 1.0 / (double) numChannels;
+
+    for (size_t i = 0; i < numAnalysed; ++i)
+    {
+        double x = 0.0;
+
+        for (size_t channel = 0; channel < numChannels; ++channel)
+            x += (double) detection.getChannelPointer (channel)[i];
+
+        x *= scale;
+
+        // Same TDF-II section as the chain, in double so it holds up at low frequencies.
+        auto y = c.b0 * x + s1;
+        s1 = c.b1 * x - c.a1 * y + s2;
+        s2 = c.b2 * x - c.a2 * y;
+
+        auto rectified = std::abs (y);
+        auto coeff = rectified > level ? attackCoeff : releaseCoeff;
+        level = rectified + coeff * (level - rectified);
+
+        envelope[i] = (float) level;
+    }
+}
+
+float DynamicBand::getGainOffset (size_t sampleIndex) const noexcept
+{
+    if (! enabled || numAnalysed == 0)
+        return 0.0f;
+
+    auto levelDecibels = juce::Decibels::gainToDecibels (envelope[juce::jmin (sampleIndex, numAnalysed - 1)], -120.0f);
+    auto overshoot = levelDecibels - thresholdDecibels;
+
+    return overshoot > 0.0f ? -overshoot * slope : 0.0f;
+}
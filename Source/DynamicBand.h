@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+
+    DynamicBand.h
+    Created: 17 Oct 2026 7:29:48am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "CoefficientDesigner.h"
+
+//==============================================================================
+/**
+    Level detector that lets the peak band act like a compressor.
+
+    The detection signal is either the main input or the sidechain bus. It is
+    summed to mono and band-passed around the peak, so only energy the band
+    acts on counts. A peak follower with separate attack and release tracks
+    it every sample. Above the threshold, the overshoot scaled by the ratio
+    comes off the band's gain. The processor only reads that offset at its
+    control ticks, so the peak is redesigned no more often than when its
+    knobs move.
+*/
+class DynamicBand
+{
+public:
+    explicit DynamicBand (juce::AudioProcessorValueTreeState& state);
+
+    static void addParameters (juce::AudioProcessorValueTreeState::ParameterLayout& layout);
+
+    /** Audio thread. Sizes the per-sample envelope; call from prepareToPlay. */
+    void prepare (double sampleRate, int maximumBlockSize);
+    void reset() noexcept;
+
+    /** Audio thread. Reads the parameters for the coming block; false when the band is static. */
+    bool update (float peakFreq, float peakQual) noexcept;
+
+    bool isEnabled() const noexcept                 { return enabled; }
+    bool wantsSidechain() const noexcept            { return useSidechain; }
+
+    /** Audio thread. Runs the detector over a block of the detection signal, at the host rate. */
+    void analyse (const juce::dsp::AudioBlock<const float>& detection) noexcept;
+    void analyse (const juce::dsp::AudioBlock<const double>& detection) noexcept;
+
+    /** The change in dB for the band at sampleIndex into the last analysed block. Never positive. */
+    float getGainOffset (size_t sampleIndex) const noexcept;
+
+private:
+    template <typename SampleType>
+    void analyseSamples (const juce::dsp::AudioBlock<const SampleType>& detection) noexcept;
+
+    std::atomic<float>* mode;
+    std::atomic<float>* detector;
+    std::atomic<float>* threshold;
+    std::atomic<float>* ratio;
+    std::atomic<float>* attack;
+    std::atomic<float>* release;
+
+    double sampleRate = 44100.0;
+    bool enabled = false, useSidechain = false;
+    float thresholdDecibels = 0.0f, slope = 0.0f;
+    double attackCoeff = 0.0, releaseCoeff = 0.0;
+
+    // Band-pass around the peak, redesigned only when the peak moves.
+    BiquadCoefficients detectorFilter;
+    float designedFreq = 0.0f, designedQual = 0.0f;
+    double s1 = 0.0, s2 = 0.0, level = 0.0;
+
+    std::vector<float> envelope;
+    size_t numAnalysed = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (DynamicBand)
+};
@@ -0,0 +1,619 @@
+/*
+  ==============================================================================
+
+    FilterChain.cpp
+    Created: 17 Oct 2026 6:57:57am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#include "FilterChain.h"
+
+template <typename SampleType>
+const std::array<typename FilterChain<SampleType>::CascadeKernel, FilterChain<SampleType>::maxSections + 1> FilterChain<SampleType>::kernels
+{
+    nullptr,
+    &FilterChain<SampleType>::template processCascade<1>,
+    &FilterChain<SampleType>::template processCascade<2>,
+    &FilterChain<SampleType>::template processCascade<3>,
+    &FilterChain<SampleType>::template processCascade<4>
+};
+
+template <typename SampleType>
+const std::array<typename FilterChain<SampleType>::SvfKernel, FilterChain<SampleType>::maxSections + 1> FilterChain<SampleType>::svfKernels
+{
+    nullptr,
+    &FilterChain<SampleType>::template processSvf<1>,
+    &FilterChain<SampleType>::template processSvf<2>,
+    &FilterChain<SampleType>::template processSvf<3>,
+    &FilterChain<SampleType>::template processSvf<4>
+};
+
+template <typename SampleType>
+void FilterChain<SampleType>::prepare (const juce::dsp::ProcessSpec& spec)
+{
+    constexpr auto lanes = Register::size();
+
+    numChannels = spec.numChannels;
+    numGroups = (numChannels + lanes - 1) / lanes;
+
+    groups.assign (numGroups, GroupState {});
+
+    // Only a layout that can go parallel needs scratch for every thread.
+    workspaces.resize (numGroups >= minParallelGroups ? (size_t) ChannelWorkers::maxParticipants : 1);
+
+    for (auto& workspace : workspaces)
+    {
+        workspace.interleaved.assign (spec.maximumBlockSize, Register::expand (0));
+        workspace.dry.assign (spec.maximumBlockSize, Register::expand (0));
+    }
+}
+
+template <typename SampleType>
+void FilterChain<SampleType>::reset() noexcept
+{
+    for (auto& group : groups)
+    {
+        group.filters.fill (Register::expand (0));
+        group.bands.fill (Register::expand (0));
+    }
+
+    for (auto& fade : fades)
+        fade.gain = fade.target;
+}
+
+template <typename SampleType>
+void FilterChain<SampleType>::setCoefficients (ChainPositions position, const BiquadCoefficients* newSections, int numSections) noexcept
+{
+    setCoefficients (position, newSections, numSections, newSections, numSections);
+}
+
+template <typename SampleType>
+void FilterChain<SampleType>::setCoefficients (ChainPositions position, const BiquadCoefficients* midSections, int numMidSections,
+                                               const BiquadCoefficients* sideSections, int numSideSections) noexcept
+{
+    jassert (numMidSections >= 0 && numMidSections <= maxSections);
+    jassert (numSideSections >= 0 && numSideSections <= maxSections);
+
+    const BiquadCoefficients passThrough;
+    auto numSections = juce::jmax (numMidSections, numSideSections);
+
+    // Every lane but the side one carries the mid sections, so outside
+    // mid/side mode (where both are the same) all channels match.
+    auto load = [] (SampleType mid, SampleType side)
+    {
+        auto r = Register::expand (mid);
+        r.set (1, side);
+        return r;
+    };
+
+    for (int i = 0; i < numSections; ++i)
+    {
+        auto& m = i < numMidSections ? midSections[i] : passThrough;
+        auto& s = i < numSideSections ? sideSections[i] : passThrough;
+        auto& section = sections[(size_t) (position * maxSections + i)];
+
+        section.b0 = load ((SampleType) m.b0, (SampleType) s.b0);
+        section.b1 = load ((SampleType) m.b1, (SampleType) s.b1);
+        section.b2 = load ((SampleType) m.b2, (SampleType) s.b2);
+        section.a1 = load ((SampleType) m.a1, (SampleType) s.a1);
+        section.a2 = load ((SampleType) m.a2, (SampleType) s.a2);
+    }
+
+    // Sections that drop out of the cascade shouldn't ring back in later,
+    // and state-variable history means nothing to a biquad.
+    if (usesSvf[(size_t) position])
+        clearState (position, 0);
+    else if (numSections < numActive[(size_t) position])
+        clearState (position, numSections);
+
+    usesSvf[(size_t) position] = false;
+    numActive[(size_t) position] = numSections;
+    activeKernels[(size_t) position] = kernels[(size_t) numSections];
+}
+
+template <typename SampleType>
+void FilterChain<SampleType>::setSvfCoefficients (ChainPositions position, const SvfCoefficients* newSections, int numSections,
+                                                  int rampSamples) noexcept
+{
+    setSvfCoefficients (position, newSections, numSections, newSections, numSections, rampSamples);
+}
+
+template <typename SampleType>
+void FilterChain<SampleType>::setSvfCoefficients (ChainPositions position, const SvfCoefficients* midSections, int numMidSections,
+                                                  const SvfCoefficients* sideSections, int numSideSections, int rampSamples) noexcept
+{
+    jassert (numMidSections >= 0 && numMidSections <= maxSections);
+    jassert (numSideSections >= 0 && numSideSections <= maxSections);
+
+    const SvfCoefficients passThrough;
+    auto numSections = juce::jmax (numMidSections, numSideSections);
+
+    // Only a position that keeps its shape can glide; anything else jumps.
+    auto glide = rampSamples > 0 && usesSvf[(size_t) position] && numActive[(size_t) position] == numSections;
+    auto perSample = Register::expand (glide ? (SampleType) 1 / (SampleType) rampSamples : (SampleType) 0);
+
+    auto load = [] (SampleType mid, SampleType side)
+    {
+        auto r = Register::expand (mid);
+        r.set (1, side);
+        return r;
+    };
+
+    for (int i = 0; i < numSections; ++i)
+    {
+        auto& m = i < numMidSections ? midSections[i] : passThrough;
+        auto& s = i < numSideSections ? sideSections[i] : passThrough;
+        auto& section = svfSections[(size_t) (position * maxSections + i)];
+
+        section.target.g  = load ((SampleType) m.g,  (SampleType) s.g);
+        section.target.k  = load ((SampleType) m.k,  (SampleType) s.k);
+        section.target.m0 = load ((SampleType) m.m0, (SampleType) s.m0);
+        section.target.m1 = load ((SampleType) m.m1, (SampleType) s.m1);
+        section.target.m2 = load ((SampleType) m.m2, (SampleType) s.m2);
+
+        if (! glide)
+            section.now = section.target;
+
+        section.step.g  = (section.target.g  - section.now.g)  * perSample;
+        section.step.k  = (section.target.k  - section.now.k)  * perSample;
+        section.step.m0 = (section.target.m0 - section.now.m0) * perSample;
+        section.step.m1 = (section.target.m1 - section.now.m1) * perSample;
+        section.step.m2 = (section.target.m2 - section.now.m2) * perSample;
+    }
+
+    if (! usesSvf[(size_t) position])
+        clearState (position, 0);
+    else if (numSections < numActive[(size_t) position])
+        clearState (position, numSections);
+
+    usesSvf[(size_t) position] = true;
+    svfRampRemaining[(size_t) position] = glide ? rampSamples : 0;
+    numActive[(size_t) position] = numSections;
+    activeKernels[(size_t) position] = kernels[(size_t) numSections];
+}
+
+template <typename SampleType>
+void FilterChain<SampleType>::setMidSide (bool shouldUseMidSide) noexcept
+{
+    midSide = shouldUseMidSide && numChannels == 2;
+}
+
+template <typename SampleType>
+void FilterChain<SampleType>::setBypassed (ChainPositions position, bool shouldBeBypassed, int numFadeSamples) noexcept
+{
+    auto& fade = fades[(size_t) position];
+    auto target = shouldBeBypassed ? (SampleType) 0 : (SampleType) 1;
+
+    if (fade.target == target)
+        return;
+
+    // Coming back in from fully bypassed: the old history is long gone.
+    if (fade.isBypassed())
+        clearState (position, 0);
+
+    fade.target = target;
+    fade.step = numFadeSamples > 0 ? (SampleType) 1 / (SampleType) numFadeSamples : (SampleType) 1;
+
+    if (numFadeSamples <= 0)
+        fade.gain = target;
+}
+
+template <typename SampleType>
+void FilterChain<SampleType>::clearState (ChainPositions position, int firstSection) noexcept
+{
+    for (auto& group : groups)
+    {
+        for (int i = firstSection; i < maxSections; ++i)
+        {
+            group.filters[(size_t) ((position * maxSections + i) * 2)] = Register::expand (0);
+            group.filters[(size_t) ((position * maxSections + i) * 2 + 1)] = Register::expand (0);
+        }
+    }
+}
+
+template <typename SampleType>
+void FilterChain<SampleType>::setBands (const BiquadCoefficients* allBands, const int* activeBands, int numActiveBands) noexcept
+{
+    jassert (numActiveBands >= 0 && numActiveBands <= maxBands);
+
+    // Repack each group's state to the new slot order. Bands that were already
+    // running keep their history; newly active ones start from silence.
+    for (auto& group : groups)
+    {
+        auto* s1 = group.bands.data();
+        auto* s2 = s1 + maxBands;
+        std::array<Register, maxBands> newS1, newS2;
+
+        for (int slot = 0; slot < numActiveBands; ++slot)
+        {
+            newS1[(size_t) slot] = newS2[(size_t) slot] = Register::expand (0);
+
+            for (int old = 0; old < numBands; ++old)
+            {
+                if (bandSlots[(size_t) old] == activeBands[slot])
+                {
+                    newS1[(size_t) slot] = s1[old];
+                    newS2[(size_t) slot] = s2[old];
+                    break;
+                }
+            }
+        }
+
+        std::copy_n (newS1.begin(), numActiveBands, s1);
+        std::copy_n (newS2.begin(), numActiveBands, s2);
+    }
+
+    for (int slot = 0; slot < numActiveBands; ++slot)
+    {
+        auto& c = allBands[activeBands[slot]];
+        bandCoeffs.b0[(size_t) slot] = Register::expand ((SampleType) c.b0);
+        bandCoeffs.b1[(size_t) slot] = Register::expand ((SampleType) c.b1);
+        bandCoeffs.b2[(size_t) slot] = Register::expand ((SampleType) c.b2);
+        bandCoeffs.a1[(size_t) slot] = Register::expand ((SampleType) c.a1);
+        bandCoeffs.a2[(size_t) slot] = Register::expand ((SampleType) c.a2);
+        bandSlots[(size_t) slot] = activeBands[slot];
+    }
+
+    numBands = numActiveBands;
+}
+
+template <typename SampleType>
+void FilterChain<SampleType>::process (const juce::dsp::ProcessContextReplacing<SampleType>& context) noexcept
+{
+    constexpr auto lanes = Register::size();
+
+    auto& block = context.getOutputBlock();
+    auto channelsToProcess = juce::jmin (block.getNumChannels(), numChannels);
+    auto numSamples = block.getNumSamples();
+
+    jassert (numSamples <= workspaces.front().interleaved.size());
+
+    if (context.isBypassed || channelsToProcess == 0)
+        return;
+
+    auto anyRunning = numBands > 0;
+
+    for (int position = 0; position < numPositions; ++position)
+        anyRunning = anyRunning || (activeKernels[(size_t) position] != nullptr && ! fades[(size_t) position].isBypassed());
+
+    if (! anyRunning)
+    {
+        if (context.usesSeparateInputAndOutputBlocks())
+            block.copyFrom (context.getInputBlock());
+
+        return;
+    }
+
+    auto numGroupsToProcess = (channelsToProcess + lanes - 1) / lanes;
+
+    if (workers != nullptr && numGroupsToProcess >= minParallelGroups && numSamples >= minParallelSamples
+        && workspaces.size() == (size_t) ChannelWorkers::maxParticipants)
+    {
+        GroupJob job { this, &context, channelsToProcess, numSamples };
+        workers->run ((int) numGroupsToProcess, &FilterChain::runGroup, &job);
+    }
+    else
+    {
+        for (size_t group = 0; group < numGroupsToProcess; ++group)
+            processGroup (context, group, channelsToProcess, numSamples, workspaces.front());
+    }
+
+    // Every group followed the same ramps; move the fades and any gliding
+    // state-variable sections on to where they ended.
+    for (int position = 0; position < numPositions; ++position)
+    {
+        if (auto remaining = svfRampRemaining[(size_t) position])
+        {
+            auto moved = juce::jmin (remaining, (int) numSamples);
+            auto distance = Register::expand ((SampleType) moved);
+
+            for (int i = 0; i < numActive[(size_t) position]; ++i)
+            {
+                auto& section = svfSections[(size_t) (position * maxSections + i)];
+
+                if (moved == remaining)
+                {
+                    section.now = section.target;
+                    continue;
+                }
+
+                section.now.g  = section.now.g  + section.step.g  * distance;
+                section.now.k  = section.now.k  + section.step.k  * distance;
+                section.now.m0 = section.now.m0 + section.step.m0 * distance;
+                section.now.m1 = section.now.m1 + section.step.m1 * distance;
+                section.now.m2 = section.now.m2 + section.step.m2 * distance;
+            }
+
+            svfRampRemaining[(size_t) position] = remaining - moved;
+        }
+
+        auto& fade = fades[(size_t) position];
+
+        if (fade.isSteady())
+            continue;
+
+        auto moved = fade.step * (SampleType) numSamples;
+        fade.gain = fade.target > fade.gain ? juce::jmin (fade.target, fade.gain + moved)
+                                            : juce::jmax (fade.target, fade.gain - moved);
+
+        if (fade.isBypassed())
+            clearState ((ChainPositions) position, 0);
+    }
+}
+
+template <typename SampleType>
+void FilterChain<SampleType>::runGroup (void* job, int group, int participant) noexcept
+{
+    auto& j = *static_cast<GroupJob*> (job);
+    j.chain->processGroup (*j.context, (size_t) group, j.numChannels, j.numSamples,
+                           j.chain->workspaces[(size_t) participant]);
+}
+
+template <typename SampleType>
+void FilterChain<SampleType>::processGroup (const juce::dsp::ProcessContextReplacing<SampleType>& context, size_t group,
+                                            size_t channelsToProcess, size_t numSamples, Workspace& workspace) noexcept
+{
+    // Called from several threads at once for different groups. Everything
+    // shared is only read here; the fades and glides move on afterwards.
+    constexpr auto lanes = Register::size();
+
+    auto& block = context.getOutputBlock();
+    auto firstChannel = group * lanes;
+    auto channelsInGroup = juce::jmin (lanes, channelsToProcess - firstChannel);
+    auto* groupState = groups[group].filters.data();
+    auto* data = workspace.interleaved.data();
+
+    interleave (context.getInputBlock(), firstChannel, channelsInGroup, numSamples, data);
+
+    for (int position = 0; position < numPositions; ++position)
+    {
+        auto numSections = (size_t) numActive[(size_t) position];
+        auto& fade = fades[(size_t) position];
+
+        if (numSections == 0 || fade.isBypassed())
+            continue;
+
+        // Mid-fade, the stage runs as usual and is then mixed with its input.
+        if (! fade.isSteady())
+            std::copy_n (data, numSamples, workspace.dry.data());
+
+        if (usesSvf[(size_t) position])
+            svfKernels[numSections] (data, numSamples,
+                                     svfSections.data() + position * maxSections,
+                                     groupState + position * maxSections * 2,
+                                     juce::jmin (numSamples, (size_t) svfRampRemaining[(size_t) position]));
+        else
+            activeKernels[(size_t) position] (data, numSamples,
+                                              sections.data() + position * maxSections,
+                                              groupState + position * maxSections * 2);
+
+        if (! fade.isSteady())
+            mixFade (data, workspace.dry.data(), numSamples, fade.gain,
+                     fade.target > fade.gain ? fade.step : -fade.step);
+    }
+
+    if (numBands > 0)
+        processBands (data, numSamples, bandCoeffs, numBands, groups[group].bands.data());
+
+    deinterleave (block, firstChannel, channelsInGroup, numSamples, data);
+}
+
+template <typename SampleType>
+void FilterChain<SampleType>::mixFade (Register* wet, const Register* dryInput, size_t numSamples,
+                                       SampleType gain, SampleType step) noexcept
+{
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+        gain = juce::jlimit ((SampleType) 0, (SampleType) 1, gain + step);
+        wet[i] = dryInput[i] + Register::expand (gain) * (wet[i] - dryInput[i]);
+    }
+}
+
+//==============================================================================
+template <typename SampleType>
+template <int NumSections>
+void FilterChain<SampleType>::processCascade (Register* data, size_t numSamples, const Section* c, Register* state) noexcept
+{
+    // Transposed direct form II, same as IIR::Filter::processSamples for order 2,
+    // but with every section of the cascade applied per sample so the state
+    // stays in registers for the whole block.
+    std::array<Register, NumSections> s1, s2;
+
+    for (int k = 0; k < NumSections; ++k)
+    {
+        s1[(size_t) k] = state[k * 2];
+        s2[(size_t) k] = state[k * 2 + 1];
+    }
+
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+        auto x = data[i];
+
+        for (size_t k = 0; k < (size_t) NumSections; ++k)
+        {
+            auto y = c[k].b0 * x + s1[k];
+            s1[k] = c[k].b1 * x - c[k].a1 * y + s2[k];
+            s2[k] = c[k].b2 * x - c[k].a2 * y;
+            x = y;
+        }
+
+        data[i] = x;
+    }
+
+    for (int k = 0; k < NumSections; ++k)
+    {
+        state[k * 2] = s1[(size_t) k];
+        state[k * 2 + 1] = s2[(size_t) k];
+    }
+}
+
+template <typename SampleType>
+template <int NumSections>
+void FilterChain<SampleType>::processSvf (Register* data, size_t numSamples, const SvfSection* c,
+                                          Register* state, size_t rampSamples) noexcept
+{
+    // Zavalishin / Simper TPT state-variable filter. Each section keeps its
+    // two integrator states in the same slots a biquad would use. While
+    // gliding, g, k and the mix step every sample and a1..a3 are worked out
+    // again; 1 / (1 + g (g + k)) goes lane by lane, as SIMDRegister has no
+    // divide. Once the glide is over they are fixed for the rest of the block.
+    std::array<SvfValues, NumSections> v;
+    std::array<Register, NumSections> a1, a2, a3, ic1, ic2;
+    const auto one = Register::expand (1);
+
+    auto derive = [&] (size_t k)
+    {
+        auto denominator = one + v[k].g * (v[k].g + v[k].k);
+
+        for (size_t lane = 0; lane < Register::size(); ++lane)
+            a1[k].set (lane, (SampleType) 1 / denominator.get (lane));
+
+        a2[k] = v[k].g * a1[k];
+        a3[k] = v[k].g * a2[k];
+    };
+
+    auto tick = [&] (Register x)
+    {
+        for (size_t k = 0; k < (size_t) NumSections; ++k)
+        {
+            auto v3 = x - ic2[k];
+            auto v1 = a1[k] * ic1[k] + a2[k] * v3;
+            auto v2 = ic2[k] + a2[k] * ic1[k] + a3[k] * v3;
+            ic1[k] = v1 + v1 - ic1[k];
+            ic2[k] = v2 + v2 - ic2[k];
+            x = v[k].m0 * x + v[k].m1 * v1 + v[k].m2 * v2;
+        }
+
+        return x;
+    };
+
+    for (size_t k = 0; k < (size_t) NumSections; ++k)
+    {
+        v[k] = c[k].now;
+        ic1[k] = state[k * 2];
+        ic2[k] = state[k * 2 + 1];
+        derive (k);
+    }
+
+    size_t i = 0;
+
+    for (; i < rampSamples; ++i)
+    {
+        for (size_t k = 0; k < (size_t) NumSections; ++k)
+        {
+            v[k].g  = v[k].g  + c[k].step.g;
+            v[k].k  = v[k].k  + c[k].step.k;
+            v[k].m0 = v[k].m0 + c[k].step.m0;
+            v[k].m1 = v[k].m1 + c[k].step.m1;
+            v[k].m2 = v[k].m2 + c[k].step.m2;
+            derive (k);
+        }
+
+        data[i] = tick (data[i]);
+    }
+
+    for (; i < numSamples; ++i)
+        data[i] = tick (data[i]);
+
+    for (size_t k = 0; k < (size_t) NumSections; ++k)
+    {
+        state[k * 2] = ic1[k];
+        state[k * 2 + 1] = ic2[k];
+    }
+}
+
+template <typename SampleType>
+void FilterChain<SampleType>::processBands (Register* data, size_t numSamples, const BandCoefficients& c,
+                                            int numActiveBands, Register* state) noexcept
+{
+    // Same TDF-II update as processCascade, but the band count is only known
+    // at run time, so the state goes through this small array instead of
+    // registers. It stays in L1 for the whole block.
+    auto* s1 = state;
+    auto* s2 = state + maxBands;
+    auto n = (size_t) numActiveBands;
+
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+        auto x = data[i];
+
+        for (size_t k = 0; k < n; ++k)
+        {
+            auto y = c.b0[k] * x + s1[k];
+            s1[k] = c.b1[k] * x - c.a1[k] * y + s2[k];
+            s2[k] = c.b2[k] * x - c.a2[k] * y;
+            x = y;
+        }
+
+        data[i] = x;
+    }
+}
+
+template <typename SampleType>
+void FilterChain<SampleType>::interleave (const juce::dsp::AudioBlock<const SampleType>& block, size_t firstChannel,
+                                          size_t channelsInGroup, size_t numSamples, Register* data) const noexcept
+{
+    auto* dest = reinterpret_cast<SampleType*> (data);
+    constexpr auto lanes = Register::size();
+
+    // The M/S encode rides along with the transpose: mid = (L + R) / 2, side = (L - R) / 2.
+    if (midSide && channelsInGroup == 2)
+    {
+        auto* left = block.getChannelPointer (firstChannel);
+        auto* right = block.getChannelPointer (firstChannel + 1);
+        const auto half = (SampleType) 0.5;
+
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            dest[i * lanes] = (left[i] + right[i]) * half;
+            dest[i * lanes + 1] = (left[i] - right[i]) * half;
+        }
+
+        return;
+    }
+
+    for (size_t ch = 0; ch < channelsInGroup; ++ch)
+    {
+        auto* src = block.getChannelPointer (firstChannel + ch);
+
+        for (size_t i = 0; i < numSamples; ++i)
+            dest[i * lanes + ch] = src[i];
+    }
+}
+
+template <typename SampleType>
+void FilterChain<SampleType>::deinterleave (juce::dsp::AudioBlock<SampleType>& block, size_t firstChannel,
+                                            size_t channelsInGroup, size_t numSamples, const Register* data) const noexcept
+{
+    auto* src = reinterpret_cast<const SampleType*> (data);
+    constexpr auto lanes = Register::size();
+
+    // And the decode on the way out: L = mid + side, R = mid - side.
+    if (midSide && channelsInGroup == 2)
+    {
+        auto* left = block.getChannelPointer (firstChannel);
+        auto* right = block.getChannelPointer (firstChannel + 1);
+
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            left[i] = src[i * lanes] + src[i * lanes + 1];
+            right[i] = src[i * lanes] - src[i * lanes + 1];
+        }
+
+        return;
+    }
+
+    for (size_t ch = 0; ch < channelsInGroup; ++ch)
+    {
+        auto* dest = block.getChannelPointer (firstChannel + ch);
+
+        for (size_t i = 0; i < numSamples; ++i)
+            dest[i] = src[i * lanes + ch];
+    }
+}
+
+//==============================================================================
+template class FilterChain<float>;
+template class FilterChain<double>;
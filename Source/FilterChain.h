@@ -0,0 +1,224 @@
+/*
+  ==============================================================================
+
+    FilterChain.h
+    Created: 17 Oct 2026 6:57:57am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "CoefficientDesigner.h"
+#include "ChannelWorkers.h"
+
+enum ChainPositions{
+  LowCut,
+  Peak,
+  HighCut,
+  numPositions
+};
+
+//==============================================================================
+/**
+    The low cut -> peak -> high cut cascade, run on any number of channels.
+
+    Channels are interleaved into the lanes of a juce::dsp::SIMDRegister (so a
+    stereo pair shares one SSE/NEON register, and up to eight channels share an
+    AVX one), pushed through each biquad once, then written back to the block.
+    Layouts wider than one register are split into groups of Register::size()
+    channels. All groups share one set of coefficients, and the filter state of
+    every group lives in a single contiguous allocation made in prepare().
+
+    Each position runs through a cascade kernel whose section count is a
+    template parameter, picked from a table whenever the slope changes, so the
+    inner loop never carries switched-off sections.
+
+    The parametric bands follow the high cut in the same pass. Their
+    coefficients and state are stored structure-of-arrays and packed down to
+    the active bands only, so a band that is off or at 0 dB costs nothing and
+    sixteen live bands still fit in a couple of kilobytes.
+
+    A position can also be bypassed. It fades out over a few milliseconds,
+    with its state still running, so reversing part-way through is seamless.
+    After that it is skipped. A chain with every position bypassed and no
+    bands returns straight away.
+
+    A position can run state-variable sections instead of biquads. Their
+    coefficients can glide to a new setting linearly, sample by sample, over
+    a control slice. The TPT structure stays stable however fast g and k
+    move, so modulation needs no per-sample redesign.
+
+    In mid/side mode a stereo pair is encoded to M/S while it is interleaved
+    and decoded while it is written back, so the matrix costs no extra pass
+    over the audio. Mid runs in lane 0 and side in lane 1, and each position
+    can load different sections per lane. The parametric bands apply to both.
+
+    Given a ChannelWorkers pool, a wide layout's groups are shared out over
+    its threads. They share nothing but the coefficients, which only change
+    between blocks. Each group's state starts on its own cache line, and each
+    thread has its own scratch. Fewer than minParallelGroups groups, or a
+    short block, run serially, where handing over would cost more than it saves.
+
+    SampleType is float or double. A double chain holds half as many channels
+    per register, but its coefficients and state keep the precision that low
+    cuts at high sample rates need.
+*/
+template <typename SampleType>
+class FilterChain
+{
+public:
+    using Register = juce::dsp::SIMDRegister<SampleType>;
+
+    static constexpr int maxSections = CoefficientDesigner::maxCutSections;
+    static constexpr size_t statesPerGroup = numPositions * maxSections * 2;
+
+    static constexpr size_t minParallelGroups = 2;
+    static constexpr size_t minParallelSamples = 64;
+
+    //==============================================================================
+    void prepare (const juce::dsp::ProcessSpec& spec);
+    void reset() noexcept;
+
+    /** Loads numSections biquads into a position; zero sections switches it off. */
+    void setCoefficients (ChainPositions position, const BiquadCoefficients* sections, int numSections) noexcept;
+
+    /** Mid/side version: the mid lane gets midSections and the side lane sideSections.
+        The shorter cascade is padded with pass-through sections. */
+    void setCoefficients (ChainPositions position, const BiquadCoefficients* midSections, int numMidSections,
+                          const BiquadCoefficients* sideSections, int numSideSections) noexcept;
+
+    /** Loads state-variable sections into a position in place of biquads. If it was
+        already running as many of them, they glide to the new values over rampSamples;
+        otherwise they jump there. */
+    void setSvfCoefficients (ChainPositions position, const SvfCoefficients* sections, int numSections,
+                             int rampSamples) noexcept;
+
+    /** Mid/side version of setSvfCoefficients, padded like setCoefficients. */
+    void setSvfCoefficients (ChainPositions position, const SvfCoefficients* midSections, int numMidSections,
+                             const SvfCoefficients* sideSections, int numSideSections, int rampSamples) noexcept;
+
+    /** Encodes a stereo pair to mid/side around the chain. Ignored for other channel counts. */
+    void setMidSide (bool shouldUseMidSide) noexcept;
+
+    /** Fades a position out of the cascade, or back in, over numFadeSamples
+        (zero switches at once). A position that comes back starts from silence. */
+    void setBypassed (ChainPositions position, bool shouldBeBypassed, int numFadeSamples) noexcept;
+
+    /** Loads the active parametric bands, given by index into allBands. State
+        follows each band as others switch in and out around it. */
+    void setBands (const BiquadCoefficients* allBands, const int* activeBands, int numActiveBands) noexcept;
+
+    /** Lets process() run channel groups on the pool's threads; nullptr keeps it serial. */
+    void setWorkers (ChannelWorkers* pool) noexcept     { workers = pool; }
+
+    void process (const juce::dsp::ProcessContextReplacing<SampleType>& context) noexcept;
+
+private:
+    struct Section
+    {
+        Register b0, b1, b2, a1, a2;
+    };
+
+    using CascadeKernel = void (*) (Register*, size_t, const Section*, Register*) noexcept;
+
+    template <int NumSections>
+    static void processCascade (Register* data, size_t numSamples, const Section* coeffs, Register* state) noexcept;
+
+    static const std::array<CascadeKernel, maxSections + 1> kernels;
+
+    struct SvfValues
+    {
+        Register g, k, m0, m1, m2;
+    };
+
+    /** Where a state-variable section is now, its per-sample step while gliding, and where it is going. */
+    struct SvfSection
+    {
+        SvfValues now, step, target;
+    };
+
+    using SvfKernel = void (*) (Register*, size_t, const SvfSection*, Register*, size_t) noexcept;
+
+    template <int NumSections>
+    static void processSvf (Register* data, size_t numSamples, const SvfSection* coeffs,
+                            Register* state, size_t rampSamples) noexcept;
+
+    static const std::array<SvfKernel, maxSections + 1> svfKernels;
+
+    /** Wet gain of a position: 1 in the cascade, 0 bypassed, in between while fading. */
+    struct Fade
+    {
+        SampleType gain = 1, target = 1, step = 0;
+
+        bool isBypassed() const noexcept    { return gain == 0 && target == 0; }
+        bool isSteady() const noexcept      { return gain == target; }
+    };
+
+    static void mixFade (Register* wet, const Register* dry, size_t numSamples, SampleType gain, SampleType step) noexcept;
+    void clearState (ChainPositions position, int firstSection) noexcept;
+
+    /** Packed active bands: one register per coefficient per band. */
+    struct BandCoefficients
+    {
+        std::array<Register, maxBands> b0, b1, b2, a1, a2;
+    };
+
+    static constexpr size_t bandStatesPerGroup = maxBands * 2;  // all s1, then all s2
+
+    /** Everything one group of channels carries between blocks, on cache lines of its own. */
+    struct alignas (64) GroupState
+    {
+        std::array<Register, statesPerGroup> filters;
+        std::array<Register, bandStatesPerGroup> bands;
+    };
+
+    /** Scratch for one thread working through groups. */
+    struct alignas (64) Workspace
+    {
+        std::vector<Register> interleaved;  // one group's worth of samples
+        std::vector<Register> dry;          // a fading position's input
+    };
+
+    /** What the pool's tasks need to find their way back to the block. */
+    struct GroupJob
+    {
+        FilterChain* chain;
+        const juce::dsp::ProcessContextReplacing<SampleType>* context;
+        size_t numChannels, numSamples;
+    };
+
+    static void runGroup (void* job, int group, int participant) noexcept;
+    void processGroup (const juce::dsp::ProcessContextReplacing<SampleType>& context, size_t group,
+                       size_t channelsToProcess, size_t numSamples, Workspace& workspace) noexcept;
+
+    static void processBands (Register* data, size_t numSamples, const BandCoefficients& coeffs,
+                              int numBands, Register* state) noexcept;
+
+    void interleave (const juce::dsp::AudioBlock<const SampleType>& block, size_t firstChannel,
+                     size_t numChannels, size_t numSamples, Register* dest) const noexcept;
+    void deinterleave (juce::dsp::AudioBlock<SampleType>& block, size_t firstChannel,
+                       size_t numChannels, size_t numSamples, const Register* src) const noexcept;
+
+    std::array<Section, numPositions * maxSections> sections;
+    std::array<int, numPositions> numActive {};
+    std::array<CascadeKernel, numPositions> activeKernels {};
+    std::array<Fade, numPositions> fades;
+
+    std::array<SvfSection, numPositions * maxSections> svfSections;
+    std::array<bool, numPositions> usesSvf {};
+    std::array<int, numPositions> svfRampRemaining {};
+
+    size_t numChannels = 0, numGroups = 0;
+    bool midSide = false;
+    std::vector<GroupState> groups;
+
+    BandCoefficients bandCoeffs;
+    std::array<int, maxBands> bandSlots {};     // band index held in each packed slot
+    int numBands = 0;
+
+    std::vector<Workspace> workspaces;  // one per thread that can run groups
+    ChannelWorkers* workers = nullptr;
+};
@@ -0,0 +1,46 @@
+/*
+  ==============================================================================
+
+    FilterSet.h
+    Created: 17 Oct 2026 6:56:07am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#pragma once
+
+enum Gradient{
+  grad12,
+  grad24,
+  grad36,
+  grad48
+};
+/** Bits describing which stages of a FilterSet differ between two snapshots. */
+enum FilterStages{
+  lowCutStage = 1 << 0,
+  peakStage = 1 << 1,
+  highCutStage = 1 << 2,
+  allStages = lowCutStage | peakStage | highCutStage
+};
+struct FilterSet{
+  float peakFreq {0},peakGain{0},peakQual{1.f};
+  float lowCutFreq {0},highCutFreq {0};
+  Gradient lowCutSlope {Gradient::grad12},highCutSlope{Gradient::grad12};
+
+  /** Returns a FilterStages mask of the stages whose settings differ from other. */
+  int getChangedStages (const FilterSet& other) const noexcept
+  {
+      int changed = 0;
+      if (lowCutFreq != other.lowCutFreq || lowCutSlope != other.lowCutSlope)
+          changed |= lowCutStage;
+      if (peakFreq != other.peakFreq || peakGain != other.peakGain || peakQual != other.peakQual)
+          changed |= peakStage;
+      if (highCutFreq != other.highCutFreq || highCutSlope != other.highCutSlope)
+          changed |= highCutStage;
+      return changed;
+  }
+
+  bool operator== (const FilterSet& other) const noexcept { return getChangedStages (other) == 0; }
+  bool operator!= (const FilterSet& other) const noexcept { return getChangedStages (other) != 0; }
+};
@@ -0,0 +1,174 @@
+/*
+  ==============================================================================
+
+    LinearPhaseEngine.cpp
+    Created: 17 Oct 2026 7:08:08am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#include "LinearPhaseEngine.h"
+
+LinearPhaseEngine::LinearPhaseEngine (const ParameterSnapshot& s, const BandParameters& b)
+    : snapshot (s), bandParams (b)
+{
+}
+
+LinearPhaseEngine::~LinearPhaseEngine()
+{
+    release();
+}
+
+void LinearPhaseEngine::prepare (const juce::dsp::ProcessSpec& newSpec)
+{
+    release();
+
+    // The audio thread isn't running, so the old engines can go now.
+    ready.store (false, std::memory_order_release);
+    engines.clear();
+    spec = newSpec;
+}
+
+void LinearPhaseEngine::release()
+{
+    follower.stop();
+}
+
+void LinearPhaseEngine::setActive (bool shouldBeActive, const FilterSet& initial)
+{
+    if (shouldBeActive == follower.isRunning())
+        return;
+
+    if (! shouldBeActive)
+    {
+        follower.stop();
+        return;
+    }
+
+    if (engines.empty())
+        allocate();
+
+    follower.start (initial);
+    ready.store (true, std::memory_order_release);
+}
+
+void LinearPhaseEngine::allocate()
+{
+    sampleRate = spec.sampleRate;
+    fftOrder = juce::jlimit (10, 17, (int) std::ceil (std::log2 (sampleRate * kernelSeconds)));
+
+    auto fftSize = 1 << fftOrder;
+    fft = std::make_unique<juce::dsp::FFT> (fftOrder);
+    spectrum.resize ((size_t) fftSize);
+    impulse.resize ((size_t) fftSize);
+
+    // One tap short of the FFT size, so the kernel is symmetric about a whole sample.
+    auto kernelLength = fftSize - 1;
+    window.resize ((size_t) kernelLength);
+    juce::dsp::WindowingFunction<float>::fillWindowingTables (window.data(), (size_t) kernelLength,
+                                                              juce::dsp::WindowingFunction<float>::blackman, false);
+    kernel.setSize (1, kernelLength);
+
+    designer.prepare (sampleRate * designOversampling);
+
+    if (queue == nullptr)
+        queue = std::make_unique<juce::dsp::ConvolutionMessageQueue>();
+
+    for (juce::uint32 channel = 0; channel < spec.numChannels; channel += 2)
+    {
+        auto* engine = engines.emplace_back (std::make_unique<juce::dsp::Convolution> (juce::dsp::Convolution::Latency { 0 }, *queue)).get();
+        engine->prepare ({ sampleRate, spec.maximumBlockSize, juce::jmin (2u, spec.numChannels - channel) });
+    }
+}
+
+void LinearPhaseEngine::reset() noexcept
+{
+    if (! isReady())
+        return;
+
+    for (auto& engine : engines)
+        engine->reset();
+}
+
+void LinearPhaseEngine::process (juce::dsp::AudioBlock<float>& block) noexcept
+{
+    for (size_t i = 0; i < engines.size(); ++i)
+    {
+        auto firstChannel = 2 * i;
+
+        if (firstChannel >= block.getNumChannels())
+            break;
+
+        auto pair = block.getSubsetChannelBlock (firstChannel, juce::jmin ((size_t) 2, block.getNumChannels() - firstChannel));
+        engines[i]->process (juce::dsp::ProcessContextReplacing<float> (pair));
+    }
+}
+
+int LinearPhaseEngine::getLatencySamples() const noexcept
+{
+    auto latency = kernel.getNumSamples() / 2;
+
+    if (! engines.empty())
+        latency += engines.front()->getLatency();
+
+    return latency;
+}
+
+//==============================================================================
+void LinearPhaseEngine::designKernel (const FilterSet& settings, const BandSet& bandSettings)
+{
+    designer.update (settings, allStages);
+
+    std::array<BiquadCoefficients, maxBands> bandCoefficients;
+    int numBands = 0;
+
+    for (auto& band : bandSettings)
+        if (band.isActive())
+            CoefficientDesigner::designBand (bandCoefficients[(size_t) numBands++], sampleRate * designOversampling, band);
+
+    auto lowCutSections = CoefficientDesigner::getNumSections (settings.lowCutSlope);
+    auto highCutSections = CoefficientDesigner::getNumSections (settings.highCutSlope);
+    auto fftSize = (int) spectrum.size();
+    auto designRate = sampleRate * designOversampling;
+
+    // Zero-phase spectrum: real, even, just the cascade's magnitude.
+    for (int bin = 0; bin <= fftSize / 2; ++bin)
+    {
+        auto omega = juce::MathConstants<double>::twoPi * (bin * sampleRate / fftSize) / designRate;
+        auto power = CoefficientDesigner::getMagnitudeSquared (designer.getPeak(), omega);
+
+        for (int i = 0; i < lowCutSections; ++i)
+            power *= CoefficientDesigner::getMagnitudeSquared (designer.getLowCut()[(size_t) i], omega);
+
+        for (int i = 0; i < highCutSections; ++i)
+            power *= CoefficientDesigner::getMagnitudeSquared (designer.getHighCut()[(size_t) i], omega);
+
+        for (int i = 0; i < numBands; ++i)
+            power *= CoefficientDesigner::getMagnitudeSquared (bandCoefficients[(size_t) i], omega);
+
+        auto magnitude = (float) std::sqrt (power);
+        spectrum[(size_t) bin] = magnitude;
+        spectrum[(size_t) ((fftSize - bin) % fftSize)] = magnitude;
+    }
+
+    fft->perform (spectrum.data(), impulse.data(), true);
+
+    // Rotate the zero-phase response so its centre lands mid-kernel, then window it.
+    auto* taps = kernel.getWritePointer (0);
+    auto kernelLength = kernel.getNumSamples();
+    auto centre = kernelLength / 2;
+
+    for (int n = 0; n < kernelLength; ++n)
+        taps[n] = impulse[(size_t) ((n - centre + fftSize) % fftSize)].real() * window[(size_t) n];
+}
+
+void LinearPhaseEngine::loadKernel()
+{
+    for (auto& engine : engines)
+    {
+        juce::AudioBuffer<float> copy (kernel);
+        engine->loadImpulseResponse (std::move (copy), sampleRate, juce::dsp::Convolution::Stereo::no,
+                                     juce::dsp::Convolution::Trim::no, juce::dsp::Convolution::Normalise::no);
+    }
+}
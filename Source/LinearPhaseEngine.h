@@ -0,0 +1,100 @@
+/*
+  ==============================================================================
+
+    LinearPhaseEngine.h
+    Created: 17 Oct 2026 7:08:08am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "CoefficientDesigner.h"
+#include "ParameterSnapshot.h"
+#include "BandParameters.h"
+#include "SettingsFollower.h"
+
+//==============================================================================
+/**
+    Linear-phase version of the EQ. A symmetric FIR takes the magnitude of the
+    low cut, peak, high cut and parametric bands, and uniformly partitioned FFT convolution
+    applies it.
+
+    While linear phase is selected, a SettingsFollower thread designs a new
+    kernel whenever the settings change, and hands it to juce::dsp::Convolution.
+    Convolution installs the kernel on the audio thread without allocating and
+    crossfades from the old one. Convolution only handles mono and stereo, so
+    wider layouts get one engine per channel pair, and every engine loads the
+    same kernel.
+
+    The magnitude comes from the biquads designed at 4x the host rate, which
+    keeps the peak and high cut clear of bilinear cramping near Nyquist.
+
+    Nothing is allocated or designed until linear phase is first selected.
+    Until then isReady() is false, and the processor stays on the minimum
+    phase path and reports its latency.
+*/
+class LinearPhaseEngine
+{
+public:
+    LinearPhaseEngine (const ParameterSnapshot& snapshot, const BandParameters& bands);
+    ~LinearPhaseEngine();
+
+    /** Message thread. Only keeps the spec; the engines are built on the first setActive (true). */
+    void prepare (const juce::dsp::ProcessSpec& spec);
+    void release();
+
+    /** Message thread. Runs the designer while linear phase is selected, starting from initial.
+        The first time after prepare() it also builds the engines and loads a kernel synchronously.
+    */
+    void setActive (bool shouldBeActive, const FilterSet& initial);
+
+    /** Any thread. True once a kernel has been loaded since prepare(). */
+    bool isReady() const noexcept                       { return ready.load (std::memory_order_acquire); }
+
+    void reset() noexcept;
+    void process (juce::dsp::AudioBlock<float>& block) noexcept;
+
+    /** Delay of the kernel's centre tap plus any the convolution adds, in samples. Needs isReady(). */
+    int getLatencySamples() const noexcept;
+
+private:
+    static constexpr double kernelSeconds = 0.15, designOversampling = 4.0;
+    static constexpr int pollMilliseconds = 20;
+
+    void allocate();
+    void designKernel (const FilterSet& settings, const BandSet& bandSettings);
+    void loadKernel();
+
+    const ParameterSnapshot& snapshot;
+    const BandParameters& bandParams;
+
+    juce::dsp::ProcessSpec spec { 44100.0, 0, 0 };
+    double sampleRate = 44100.0;
+    int fftOrder = 0;
+
+    // Built by the first setActive (true). The audio thread only touches
+    // the engines once ready is set.
+    std::unique_ptr<juce::dsp::ConvolutionMessageQueue> queue;
+    std::vector<std::unique_ptr<juce::dsp::Convolution>> engines;
+    std::atomic<bool> ready { false };
+
+    // Designer thread only (or the message thread while it is stopped).
+    CoefficientDesigner designer;
+    std::unique_ptr<juce::dsp::FFT> fft;
+    std::vector<std::complex<float>> spectrum, impulse;
+    std::vector<float> window;
+    juce::AudioBuffer<float> kernel;
+
+    // Last, so it stops before anything it designs into goes away.
+    SettingsFollower follower { "Vonic linear phase", snapshot, bandParams, pollMilliseconds,
+                                [this] (const FilterSet& settings, const BandSet& bandSettings, double)
+                                {
+                                    designKernel (settings, bandSettings);
+                                    loadKernel();
+                                } };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LinearPhaseEngine)
+};
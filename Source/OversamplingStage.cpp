@@ -0,0 +1,135 @@
+/*
+  ==============================================================================
+
+    OversamplingStage.cpp
+    Created: 17 Oct 2026 7:06:17am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#include "OversamplingStage.h"
+
+void OversamplingStage::prepare (const juce::dsp::ProcessSpec& newSpec)
+{
+    spec = newSpec;
+    factorIndex = 0;
+    mode = polyphaseIIR;
+
+    for (auto& modeFlags : built)
+        for (auto& flag : modeFlags)
+            flag.store (false, std::memory_order_relaxed);
+
+    // The audio thread isn't running, so nothing can still be using these.
+    singleEngines = {};
+    doubleEngines = {};
+}
+
+void OversamplingStage::allocate (int index, Mode m)
+{
+    index = juce::jlimit (0, maxFactorIndex, index);
+
+    if (isBuilt (index, m))
+        return;
+
+    singleEngines.build (spec, index, m);
+    doubleEngines.build (spec, index, m);
+    built[(size_t) m][(size_t) index].store (true, std::memory_order_release);
+}
+
+bool OversamplingStage::select (int newFactorIndex, Mode newMode) noexcept
+{
+    newFactorIndex = juce::jlimit (0, maxFactorIndex, newFactorIndex);
+
+    if ((newFactorIndex == factorIndex && newMode == mode) || ! isBuilt (newFactorIndex, newMode))
+        return false;
+
+    factorIndex = newFactorIndex;
+    mode = newMode;
+    singleEngines.select (factorIndex, mode);
+    doubleEngines.select (factorIndex, mode);
+    reset();
+    return true;
+}
+
+void OversamplingStage::reset() noexcept
+{
+    singleEngines.reset();
+    doubleEngines.reset();
+}
+
+int OversamplingStage::getLatencySamples (int index, Mode m) const noexcept
+{
+    index = juce::jlimit (0, maxFactorIndex, index);
+
+    if (! isBuilt (index, m))
+        return 0;
+
+    // Both precisions use the same half-band designs, so either set will do.
+    auto& engine = singleEngines.engines[(size_t) m][(size_t) juce::jlimit (0, maxFactorIndex, index)];
+    return engine != nullptr ? juce::roundToInt (engine->getLatencyInSamples()) : 0;
+}
+
+juce::dsp::AudioBlock<float> OversamplingStage::processUp (juce::dsp::AudioBlock<float>& block) noexcept
+{
+    return singleEngines.processUp (block);
+}
+
+juce::dsp::AudioBlock<double> OversamplingStage::processUp (juce::dsp::AudioBlock<double>& block) noexcept
+{
+    return doubleEngines.processUp (block);
+}
+
+void OversamplingStage::processDown (juce::dsp::AudioBlock<float>& block) noexcept
+{
+    singleEngines.processDown (block);
+}
+
+void OversamplingStage::processDown (juce::dsp::AudioBlock<double>& block) noexcept
+{
+    doubleEngines.processDown (block);
+}
+
+//==============================================================================
+template <typename SampleType>
+void OversamplingStage::Engines<SampleType>::build (const juce::dsp::ProcessSpec& spec, int factorIndex, Mode mode)
+{
+    using Filter = typename juce::dsp::Oversampling<SampleType>::FilterType;
+
+    auto filter = mode == polyphaseIIR ? Filter::filterHalfBandPolyphaseIIR
+                                       : Filter::filterHalfBandFIREquiripple;
+
+    auto& engine = engines[(size_t) mode][(size_t) factorIndex];
+    engine = std::make_unique<juce::dsp::Oversampling<SampleType>> ((size_t) spec.numChannels, (size_t) factorIndex,
+                                                                    filter, true, true);
+    engine->initProcessing ((size_t) spec.maximumBlockSize);
+}
+
+template <typename SampleType>
+void OversamplingStage::Engines<SampleType>::select (int factorIndex, Mode mode) noexcept
+{
+    active = engines[(size_t) mode][(size_t) factorIndex].get();
+}
+
+template <typename SampleType>
+void OversamplingStage::Engines<SampleType>::reset() noexcept
+{
+    if (active != nullptr)
+        active->reset();
+}
+
+template <typename SampleType>
+juce::dsp::AudioBlock<SampleType> OversamplingStage::Engines<SampleType>::processUp (juce::dsp::AudioBlock<SampleType>& block) noexcept
+{
+    if (active == nullptr)
+        return block;
+
+    return active->processSamplesUp (block);
+}
+
+template <typename SampleType>
+void OversamplingStage::Engines<SampleType>::processDown (juce::dsp::AudioBlock<SampleType>& block) noexcept
+{
+    if (active != nullptr)
+        active->processSamplesDown (block);
+}
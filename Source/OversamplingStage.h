@@ -0,0 +1,95 @@
+/*
+  ==============================================================================
+
+    OversamplingStage.h
+    Created: 17 Oct 2026 7:06:17am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Runs the filter chain at 2x, 4x or 8x the host rate, so the bilinear peak
+    keeps its shape close to Nyquist.
+
+    Engines are only built for settings that have actually been chosen.
+    allocate() builds them on the message thread. Switching with select() on
+    the audio thread then only swaps a pointer and clears the new engine's
+    history, and it waits for allocate() if the setting is new. There is a
+    float and a double engine for each setting, one for each precision the
+    chain can run in.
+*/
+class OversamplingStage
+{
+public:
+    enum Mode
+    {
+        polyphaseIIR,     // cheap and minimum phase; good for tracking
+        linearPhaseFIR,   // equiripple half-bands; more latency, no phase shift
+        numModes
+    };
+
+    static constexpr int maxFactorIndex = 3;   // 2^3 = 8x
+
+    static juce::StringArray getFactorNames()   { return { "Off", "2x", "4x", "8x" }; }
+    static juce::StringArray getModeNames()     { return { "Polyphase IIR", "Linear-phase FIR" }; }
+
+    /** Message thread. Drops every engine and goes back to no oversampling. */
+    void prepare (const juce::dsp::ProcessSpec& spec);
+
+    /** Message thread. Builds the engines for one setting, if they aren't there yet. */
+    void allocate (int factorIndex, Mode mode);
+
+    /** Audio thread. Returns true if the factor or mode changed. A setting that
+        allocate() hasn't built yet is left for a later call.
+    */
+    bool select (int factorIndex, Mode mode) noexcept;
+
+    int getFactor() const noexcept      { return 1 << factorIndex; }
+
+    /** Audio thread. Clears the history of the selected engines. */
+    void reset() noexcept;
+
+    /** Latency in host-rate samples for a given setting, rounded to whole samples. Zero until it is built. */
+    int getLatencySamples (int factorIndex, Mode mode) const noexcept;
+
+    /** Returns the block to filter: the upsampled copy, or the input itself when off. */
+    juce::dsp::AudioBlock<float> processUp (juce::dsp::AudioBlock<float>& block) noexcept;
+    juce::dsp::AudioBlock<double> processUp (juce::dsp::AudioBlock<double>& block) noexcept;
+    void processDown (juce::dsp::AudioBlock<float>& block) noexcept;
+    void processDown (juce::dsp::AudioBlock<double>& block) noexcept;
+
+private:
+    template <typename SampleType>
+    struct Engines
+    {
+        std::array<std::array<std::unique_ptr<juce::dsp::Oversampling<SampleType>>, maxFactorIndex + 1>, numModes> engines;
+        juce::dsp::Oversampling<SampleType>* active = nullptr;
+
+        void build (const juce::dsp::ProcessSpec& spec, int factorIndex, Mode mode);
+        void select (int factorIndex, Mode mode) noexcept;
+        void reset() noexcept;
+        juce::dsp::AudioBlock<SampleType> processUp (juce::dsp::AudioBlock<SampleType>& block) noexcept;
+        void processDown (juce::dsp::AudioBlock<SampleType>& block) noexcept;
+    };
+
+    bool isBuilt (int index, Mode m) const noexcept
+    {
+        return index == 0 || built[(size_t) m][(size_t) index].load (std::memory_order_acquire);
+    }
+
+    juce::dsp::ProcessSpec spec { 44100.0, 0, 0 };
+    Engines<float> singleEngines;
+    Engines<double> doubleEngines;
+
+    // Set by allocate() once both precisions' engines for a setting exist.
+    std::array<std::array<std::atomic<bool>, maxFactorIndex + 1>, numModes> built {};
+
+    int factorIndex = 0;
+    Mode mode = polyphaseIIR;
+};
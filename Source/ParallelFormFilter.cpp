@@ -0,0 +1,274 @@
+/*
+  ==============================================================================
+
+    ParallelFormFilter.cpp
+    Created: 17 Oct 2026 7:18:40am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#include "ParallelFormFilter.h"
+
+namespace
+{
+    using Complex = std::complex<double>;
+
+    // Poles closer than this make the residues blow up.
+    constexpr double minPoleDistance = 1.0e-7;
+
+    // The float sections must match the cascade to within about 0.02 dB, plus
+    // an error floor near -70 dB. Low poles at high rates eat into that the most.
+    constexpr double relativeTolerance = 2.0e-3, absoluteTolerance = 3.0e-4;
+    constexpr int numChecks = 48;
+
+    /** Numerator and denominator of one section, as polynomials in w = z^-1. */
+    Complex evaluateNumerator (const BiquadCoefficients& c, Complex w) noexcept
+    {
+        return c.b0 + w * (c.b1 + w * c.b2);
+    }
+
+    Complex evaluateDenominator (const BiquadCoefficients& c, Complex w) noexcept
+    {
+        return 1.0 + w * (c.a1 + w * c.a2);
+    }
+}
+
+//==============================================================================
+ParallelFormFilter::ParallelFormFilter (const ParameterSnapshot& s, const BandParameters& b)
+    : snapshot (s), bandParams (b)
+{
+}
+
+ParallelFormFilter::~ParallelFormFilter()
+{
+    release();
+}
+
+bool ParallelFormFilter::convert (const BiquadCoefficients* series, int numSeries, Design& dest) noexcept
+{
+    dest.valid = false;
+    dest.numSections = numSeries;
+
+    if (numSeries <= 0 || numSeries > maxSections)
+        return false;
+
+    // Every section brings its own pole pair, so there is no root finding
+    // beyond the quadratic formula.
+    std::array<std::array<Complex, 2>, maxSections> poles;
+    auto direct = 1.0;
+
+    for (int k = 0; k < numSeries; ++k)
+    {
+        auto a1 = series[k].a1;
+        auto a2 = series[k].a2;
+
+        // A pole at the origin leaves nothing for the direct term to divide by.
+        if (std::abs (a2) < 1.0e-12)
+            return false;
+
+        auto root = std::sqrt (Complex (a1 * a1 - 4.0 * a2));
+        poles[(size_t) k] = { 0.5 * (-a1 + root), 0.5 * (-a1 - root) };
+        direct *= series[k].b2 / a2;
+    }
+
+    for (int i = 0; i < 2 * numSeries; ++i)
+        for (int j = i + 1; j < 2 * numSeries; ++j)
+            if (std::abs (poles[(size_t) (i / 2)][(size_t) (i % 2)] - poles[(size_t) (j / 2)][(size_t) (j % 2)]) < minPoleDistance)
+                return false;
+
+    // Residue of each pole p: (1 - p w) H(w) at w = 1/p. Both poles of a
+    // section then combine back into one real first-order numerator.
+    for (int k = 0; k < numSeries; ++k)
+    {
+        auto& pair = poles[(size_t) k];
+        Complex residues[2];
+
+        for (int side = 0; side < 2; ++side)
+        {
+            auto w = 1.0 / pair[(size_t) side];
+            auto num = Complex (1.0);
+            auto den = 1.0 - pair[(size_t) (1 - side)] * w;
+
+            for (int i = 0; i < numSeries; ++i)
+            {
+                num *= evaluateNumerator (series[i], w);
+
+                if (i != k)
+                    den *= evaluateDenominator (series[i], w);
+            }
+
+            residues[side] = num / den;
+        }
+
+        // Rounded to float here, since that is what process() runs on.
+        auto& section = dest.sections[(size_t) k];
+        section.b0 = (float) (residues[0] + residues[1]).real();
+        section.b1 = (float) -(residues[0] * pair[1] + residues[1] * pair[0]).real();
+        section.b2 = 0.f;
+        section.a1 = (float) series[k].a1;
+        section.a2 = (float) series[k].a2;
+    }
+
+    dest.direct = (float) direct;
+
+    // Check the rounded sections against the cascade on a log grid up to
+    // just short of Nyquist. Ill-conditioned expansions fail here.
+    for (int i = 0; i < numChecks; ++i)
+    {
+        auto omega = juce::MathConstants<double>::pi * std::pow (10.0, -4.0 + 4.0 * i / (numChecks - 1.0)) * 0.98;
+        auto w = std::polar (1.0, -omega);
+        auto cascade = Complex (1.0);
+        auto parallel = Complex ((double) dest.direct);
+
+        for (int k = 0; k < numSeries; ++k)
+        {
+            cascade *= evaluateNumerator (series[k], w) / evaluateDenominator (series[k], w);
+            parallel += evaluateNumerator (dest.sections[(size_t) k], w) / evaluateDenominator (dest.sections[(size_t) k], w);
+        }
+
+        if (std::abs (parallel - cascade) > relativeTolerance * std::abs (cascade) + absoluteTolerance)
+            return false;
+    }
+
+    dest.valid = true;
+    return true;
+}
+
+//==============================================================================
+void ParallelFormFilter::prepare (const juce::dsp::ProcessSpec& spec, double rate)
+{
+    release();
+
+    follower.setDesignRate (rate);
+    state.assign ((size_t) spec.numChannels * maxPacks * 2, Register::expand (0.f));
+    numSections = 0;
+    loaded = false;
+}
+
+void ParallelFormFilter::release()
+{
+    follower.stop();
+}
+
+void ParallelFormFilter::setActive (bool shouldBeActive, const FilterSet& initial)
+{
+    if (shouldBeActive == follower.isRunning())
+        return;
+
+    // The first design is posted from here, before the thread starts.
+    if (shouldBeActive)
+        follower.start (initial);
+    else
+        follower.stop();
+}
+
+void ParallelFormFilter::setEnabled (bool shouldBeEnabled) noexcept
+{
+    // Whatever is loaded may be long out of date by the time it is used again.
+    if (! shouldBeEnabled)
+        loaded = false;
+}
+
+bool ParallelFormFilter::update (double sampleRate) noexcept
+{
+    if (handover.fetch (fetched))
+        load (fetched);
+
+    return loaded && loadedRate == sampleRate;
+}
+
+void ParallelFormFilter::reset() noexcept
+{
+    std::fill (state.begin(), state.end(), Register::expand (0.f));
+}
+
+void ParallelFormFilter::load (const Design& source) noexcept
+{
+    loaded = source.valid;
+    loadedRate = source.sampleRate;
+
+    if (! loaded)
+        return;
+
+    // Sections follow the cascade one for one, so their state carries over
+    // while the layout stays the same.
+    if (source.numSections != numSections)
+        reset();
+
+    numSections = source.numSections;
+    numPacks = (numSections + lanes - 1) / lanes;
+    direct = source.direct;
+
+    const BiquadCoefficients unused { 0.0, 0.0, 0.0, 0.0, 0.0 };
+
+    for (int pack = 0; pack < numPacks; ++pack)
+    {
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            auto index = pack * lanes + lane;
+            auto& section = index < numSections ? source.sections[(size_t) index] : unused;
+
+            c0[(size_t) pack].set ((size_t) lane, (float) section.b0);
+            c1[(size_t) pack].set ((size_t) lane, (float) section.b1);
+            a1[(size_t) pack].set ((size_t) lane, (float) section.a1);
+            a2[(size_t) pack].set ((size_t) lane, (float) section.a2);
+        }
+    }
+}
+
+void ParallelFormFilter::process (juce::dsp::AudioBlock<float>& block) noexcept
+{
+    const auto numSamples = block.getNumSamples();
+    const auto numChannels = juce::jmin (block.getNumChannels(), state.size() / (2 * maxPacks));
+
+    for (size_t channel = 0; channel < numChannels; ++channel)
+    {
+        auto* data = block.getChannelPointer (channel);
+        auto* s1 = state.data() + channel * 2 * maxPacks;
+        auto* s2 = s1 + maxPacks;
+
+        // Transposed direct form II with b2 == 0; s2 holds a2 * y, so it is subtracted.
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            auto x = Register::expand (data[i]);
+            auto sum = Register::expand (0.f);
+
+            for (int pack = 0; pack < numPacks; ++pack)
+            {
+                auto y = c0[(size_t) pack] * x + s1[pack];
+                s1[pack] = c1[(size_t) pack] * x - a1[(size_t) pack] * y - s2[pack];
+                s2[pack] = a2[(size_t) pack] * y;
+                sum += y;
+            }
+
+            data[i] = direct * data[i] + sum.sum();
+        }
+    }
+}
+
+//==============================================================================
+void ParallelFormFilter::design (const FilterSet& settings, const BandSet& bandSettings, double rate, Design& dest) noexcept
+{
+    designer.prepare (rate);
+    designer.update (settings, allStages);
+
+    // Same order as the cascade: low cut, peak, high cut, then the active bands.
+    std::array<BiquadCoefficients, maxSections> series;
+    int numSeries = 0;
+
+    for (int i = 0; i < CoefficientDesigner::getNumSections (settings.lowCutSlope); ++i)
+        series[(size_t) numSeries++] = designer.getLowCut()[(size_t) i];
+
+    series[(size_t) numSeries++] = designer.getPeak();
+
+    for (int i = 0; i < CoefficientDesigner::getNumSections (settings.highCutSlope); ++i)
+        series[(size_t) numSeries++] = designer.getHighCut()[(size_t) i];
+
+    for (auto& band : bandSettings)
+        if (band.isActive())
+            CoefficientDesigner::designBand (series[(size_t) numSeries++], rate, band);
+
+    dest.sampleRate = rate;
+    convert (series.data(), numSeries, dest);
+}
@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+    ParallelFormFilter.h
+    Created: 17 Oct 2026 7:18:40am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "CoefficientDesigner.h"
+#include "ParameterSnapshot.h"
+#include "BandParameters.h"
+#include "RealtimeHandover.h"
+#include "SettingsFollower.h"
+
+//==============================================================================
+/**
+    The whole EQ as a parallel sum of second-order sections instead of a cascade.
+
+    A partial fraction expansion turns the low cut, peak, high cut and active
+    bands into one direct gain plus one section per cascade section, all fed
+    the same input:
+
+        H(z) = d + sum_k (c0_k + c1_k z^-1) / (1 + a1_k z^-1 + a2_k z^-2)
+
+    The sections no longer depend on each other, so one channel's sections
+    run Register::size() wide (four per SSE/NEON register, eight per AVX
+    register), even for mono. That is a big win when many bands are on.
+
+    While the parallel form is selected, a SettingsFollower thread does the
+    expansion in double precision whenever the settings change. It hands each result to the audio
+    thread through a RealtimeHandover. The conversion breaks down with
+    coincident poles (for example two identical bands), or when it loses too
+    much precision. In those cases the design is marked invalid and the
+    processor keeps using the series chain.
+
+    Parameters step between designs rather than gliding, as in linear phase.
+*/
+class ParallelFormFilter
+{
+public:
+    using Register = juce::dsp::SIMDRegister<float>;
+
+    static constexpr int maxSections = 3 * CoefficientDesigner::maxCutSections + maxBands;
+    static constexpr int lanes = (int) Register::size();
+    static constexpr int maxPacks = (maxSections + lanes - 1) / lanes;
+
+    struct Design
+    {
+        bool valid = false;
+        double sampleRate = 0.0;
+        int numSections = 0;
+        float direct = 0.f;
+        std::array<BiquadCoefficients, maxSections> sections;  // b2 is always zero
+    };
+
+    ParallelFormFilter (const ParameterSnapshot& snapshot, const BandParameters& bands);
+    ~ParallelFormFilter();
+
+    /** Expands a cascade into parallel form. Returns false if it can't be done accurately. */
+    static bool convert (const BiquadCoefficients* series, int numSeries, Design& dest) noexcept;
+
+    /** Message thread. Sizes the state; nothing is designed until setActive (true). */
+    void prepare (const juce::dsp::ProcessSpec& spec, double designRate);
+    void release();
+
+    /** Message thread. Runs the converter while the parallel form is selected, starting from initial. */
+    void setActive (bool shouldBeActive, const FilterSet& initial);
+
+    /** Audio thread. Forgets the loaded design while the parallel form isn't in use. */
+    void setEnabled (bool shouldBeEnabled) noexcept;
+    void setDesignRate (double newRate) noexcept        { follower.setDesignRate (newRate); }
+
+    /** Audio thread. Picks up any new design, and returns true if a valid one for this rate is loaded. */
+    bool update (double sampleRate) noexcept;
+
+    void reset() noexcept;
+    void process (juce::dsp::AudioBlock<float>& block) noexcept;
+
+private:
+    static constexpr int pollMilliseconds = 10;
+
+    void design (const FilterSet& settings, const BandSet& bandSettings, double rate, Design& dest) noexcept;
+    void load (const Design& source) noexcept;
+
+    const ParameterSnapshot& snapshot;
+    const BandParameters& bandParams;
+
+    RealtimeHandover<Design> handover;
+
+    // Audio thread only. Unused lanes of the last pack have zero coefficients.
+    Design fetched;
+    bool loaded = false;
+    double loadedRate = 0.0;
+    int numSections = 0, numPacks = 0;
+    float direct = 0.f;
+    std::array<Register, maxPacks> c0, c1, a1, a2;
+    std::vector<Register> state;     // per channel: maxPacks s1, then maxPacks s2
+
+    // Converter thread only (or the message thread while it is stopped).
+    CoefficientDesigner designer;
+
+    // Last, so it stops before the designer and handover go away.
+    SettingsFollower follower { "Vonic parallel form", snapshot, bandParams, pollMilliseconds,
+                                [this] (const FilterSet& settings, const BandSet& bandSettings, double rate)
+                                {
+                                    handover.post ([&] (Design& slot) { design (settings, bandSettings, rate, slot); });
+                                } };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParallelFormFilter)
+};
@@ -0,0 +1,104 @@
+/*
+  ==============================================================================
+
+    ParameterSnapshot.cpp
+    Created: 17 Oct 2026 6:57:00am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#include "ParameterSnapshot.h"
+
+ParameterSnapshot::ParameterSnapshot (juce::AudioProcessorValueTreeState& state, const juce::String& prefix)
+    : lowCutFreq (state.getRawParameterValue (prefix + "HighPass")),
+      highCutFreq (state.getRawParameterValue (prefix + "LowPass")),
+      peakFreq (state.getRawParameterValue (prefix + "Peak")),
+      peakGain (state.getRawParameterValue (prefix + "Gain")),
+      peakQual (state.getRawParameterValue (prefix + "Quality")),
+      lowCutSlope (state.getRawParameterValue (prefix + "HighPassGrad")),
+      highCutSlope (state.getRawParameterValue (prefix + "LowPassGrad"))
+{
+    jassert (lowCutFreq != nullptr && highCutFreq != nullptr && peakFreq != nullptr && peakGain != nullptr
+             && peakQual != nullptr && lowCutSlope != nullptr && highCutSlope != nullptr);
+
+    current = load();
+    publish (current);
+}
+
+int ParameterSnapshot::update() noexcept
+{
+    auto latest = load();
+    auto changed = forceAll ? (int) allStages : latest.getChangedStages (current);
+
+    if (changed != 0)
+    {
+        current = latest;
+        forceAll = false;
+        publish (current);
+    }
+
+    return changed;
+}
+
+FilterSet ParameterSnapshot::read (juce::uint32* generation) const noexcept
+{
+    for (;;)
+    {
+        auto before = sequence.load (std::memory_order_acquire);
+
+        if ((before & 1) == 0)
+        {
+            FilterSet props;
+            props.lowCutFreq  = published[0].load (std::memory_order_relaxed);
+            props.highCutFreq = published[1].load (std::memory_order_relaxed);
+            props.peakFreq    = published[2].load (std::memory_order_relaxed);
+            props.peakGain    = published[3].load (std::memory_order_relaxed);
+            props.peakQual    = published[4].load (std::memory_order_relaxed);
+            props.lowCutSlope  = static_cast<Gradient> ((int) published[5].load (std::memory_order_relaxed));
+            props.highCutSlope = static_cast<Gradient> ((int) published[6].load (std::memory_order_relaxed));
+
+            std::atomic_thread_fence (std::memory_order_acquire);
+
+            if (sequence.load (std::memory_order_relaxed) == before)
+            {
+                if (generation != nullptr)
+                    *generation = before >> 1;
+
+                return props;
+            }
+        }
+    }
+}
+
+//==============================================================================
+FilterSet ParameterSnapshot::load() const noexcept
+{
+    FilterSet props;
+    props.lowCutFreq = lowCutFreq->load (std::memory_order_relaxed);
+    props.highCutFreq = highCutFreq->load (std::memory_order_relaxed);
+    props.peakFreq = peakFreq->load (std::memory_order_relaxed);
+    props.peakGain = peakGain->load (std::memory_order_relaxed);
+    props.peakQual = peakQual->load (std::memory_order_relaxed);
+    props.lowCutSlope = static_cast<Gradient> ((int) lowCutSlope->load (std::memory_order_relaxed));
+    props.highCutSlope = static_cast<Gradient> ((int) highCutSlope->load (std::memory_order_relaxed));
+    return props;
+}
+
+void ParameterSnapshot::publish (const FilterSet& settings) noexcept
+{
+    // Single writer (the audio thread), so a plain seqlock is enough.
+    auto seq = sequence.load (std::memory_order_relaxed);
+    sequence.store (seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence (std::memory_order_release);
+
+    published[0].store (settings.lowCutFreq, std::memory_order_relaxed);
+    published[1].store (settings.highCutFreq, std::memory_order_relaxed);
+    published[2].store (settings.peakFreq, std::memory_order_relaxed);
+    published[3].store (settings.peakGain, std::memory_order_relaxed);
+    published[4].store (settings.peakQual, std::memory_order_relaxed);
+    published[5].store ((float) settings.lowCutSlope, std::memory_order_relaxed);
+    published[6].store ((float) settings.highCutSlope, std::memory_order_relaxed);
+
+    sequence.store (seq + 2, std::memory_order_release);
+}
@@ -0,0 +1,69 @@
+/*
+  ==============================================================================
+
+    ParameterSnapshot.h
+    Created: 17 Oct 2026 6:57:00am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FilterSet.h"
+
+//==============================================================================
+/**
+    Audio thread view of the EQ parameters.
+
+    The raw parameter atomics are looked up once by ID in the constructor
+    (with an optional prefix, e.g. "Side" for the mid/side side set), so
+    update() is just seven relaxed loads and a compare. Whenever something moved
+    the new FilterSet is published through a seqlock with a generation counter,
+    which other threads (the editor, background designers) can poll cheaply.
+*/
+class ParameterSnapshot
+{
+public:
+    explicit ParameterSnapshot (juce::AudioProcessorValueTreeState& state, const juce::String& prefix = {});
+
+    /** Audio thread only. Returns a FilterStages mask of what changed since the last call. */
+    int update() noexcept;
+
+    /** Makes the next update() report every stage as changed, e.g. after prepareToPlay. */
+    void invalidate() noexcept                      { forceAll = true; }
+
+    /** The set read by the last update(). Audio thread only. */
+    const FilterSet& getCurrent() const noexcept    { return current; }
+
+    /** Any thread. Returns the last published set, and optionally its generation. */
+    FilterSet read (juce::uint32* generation = nullptr) const noexcept;
+
+    /** Any thread. Bumped every time update() publishes a new set. */
+    juce::uint32 getGeneration() const noexcept     { return sequence.load (std::memory_order_acquire) >> 1; }
+
+    /** Any thread. Reads the parameters themselves rather than the published set,
+        so it is current even while the audio thread isn't running. */
+    FilterSet load() const noexcept;
+
+private:
+    void publish (const FilterSet& settings) noexcept;
+
+    std::atomic<float>* lowCutFreq;
+    std::atomic<float>* highCutFreq;
+    std::atomic<float>* peakFreq;
+    std::atomic<float>* peakGain;
+    std::atomic<float>* peakQual;
+    std::atomic<float>* lowCutSlope;
+    std::atomic<float>* highCutSlope;
+
+    FilterSet current;
+    bool forceAll = true;
+
+    // Odd while a write is in progress; the generation is sequence / 2.
+    std::atomic<juce::uint32> sequence {0};
+    std::array<std::atomic<float>, 7> published;
+
+    JUCE_DECLARE_NON_COPYABLE (ParameterSnapshot)
+};
@@ -10,13 +10,103 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
+//==============================================================================
+VonicRewriteAudioProcessorEditor::RotaryControl::RotaryControl (juce::AudioProcessorValueTreeState& state, const juce::String& parameterID)
+    : attachment (state, parameterID, slider)
+{
+    slider.setSliderStyle (juce::Slider::RotaryHorizontalVerticalDrag);
+    slider.setTextBoxStyle (juce::Slider::TextBoxBelow, false, 80, 18);
+    label.setText (parameterID, juce::dontSendNotification);
+    label.setJustificationType (juce::Justification::centred);
+}
+
+VonicRewriteAudioProcessorEditor::ChoiceControl::ChoiceControl (juce::AudioProcessorValueTreeState& state, const juce::String& parameterID)
+{
+    // The items have to be there before the attachment syncs the selection.
+    if (auto* choice = dynamic_cast<juce::AudioParameterChoice*> (state.getParameter (parameterID)))
+        box.addItemList (choice->choices, 1);
+
+    attachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment> (state, parameterID, box);
+    label.setText (parameterID, juce::dontSendNotification);
+    label.setJustificationType (juce::Justification::centred);
+}
+
 //==============================================================================
 VonicRewriteAudioProcessorEditor::VonicRewriteAudioProcessorEditor (VonicRewriteAudioProcessor& p)
-    : AudioProcessorEditor (&p), audioProcessor (p)
+    : AudioProcessorEditor (&p), audioProcessor (p), analyzer (p), responseCurve (p),
+      phaseMode (p.bleh.getRawParameterValue ("PhaseMode")), structure (p.bleh.getRawParameterValue ("Structure"))
 {
+    const juce::StringArray dynamicIDs { "Dynamic", "Detector", "Threshold", "Ratio", "Attack", "Release" };
+
+    addAndMakeVisible (analyzer);
+    addAndMakeVisible (responseCurve);
+
+    for (auto id : { "HighPass", "Peak", "Gain", "Quality", "LowPass", "Threshold", "Ratio", "Attack", "Release" })
+    {
+        auto* knob = knobs.add (new RotaryControl (p.bleh, id));
+        addAndMakeVisible (knob->slider);
+        addAndMakeVisible (knob->label);
+
+        if (dynamicIDs.contains (id))
+        {
+            dynamicControls.add (&knob->slider);
+            dynamicControls.add (&knob->label);
+        }
+    }
+
+    for (auto id : { "SideHighPass", "SidePeak", "SideGain", "SideQuality", "SideLowPass" })
+    {
+        auto* knob = sideKnobs.add (new RotaryControl (p.bleh, id));
+        addAndMakeVisible (knob->slider);
+        addAndMakeVisible (knob->label);
+    }
+
+    for (auto id : { "HighPassGrad", "LowPassGrad", "Oversampling", "OversamplingMode", "PhaseMode", "Structure", "Precision", "Engine", "Dynamic", "Detector",
+                     "StereoMode", "SideHighPassGrad", "SideLowPassGrad", "Threading" })
+    {
+        auto* choice = choices.add (new ChoiceControl (p.bleh, id));
+        addAndMakeVisible (choice->box);
+        addAndMakeVisible (choice->label);
+
+        if (dynamicIDs.contains (id))
+        {
+            dynamicControls.add (&choice->box);
+            dynamicControls.add (&choice->label);
+        }
+    }
+
+    updateDynamicControls();
+
+    for (int band = 0; band < maxBands; ++band)
+        bandSelector.addItem ("Band " + juce::String (band + 1), band + 1);
+
+    bandSelector.onChange = [this] { showBand (bandSelector.getSelectedItemIndex()); };
+    addAndMakeVisible (bandSelector);
+    bandSelector.setSelectedItemIndex (0, juce::sendNotificationSync);
+
+    statsLabel.setFont (juce::Font (juce::Font::getDefaultMonospacedFontName(), 12.0f, juce::Font::plain));
+    statsLabel.setJustificationType (juce::Justification::centredLeft);
+    addAndMakeVisible (statsLabel);
+
+    auto& monitor = audioProcessor.getRealtimeMonitor();
+    thresholdLabel.setText ("Overrun at", juce::dontSendNotification);
+    thresholdLabel.attachToComponent (&overrunThreshold, true);
+    overrunThreshold.setSliderStyle (juce::Slider::LinearHorizontal);
+    overrunThreshold.setTextBoxStyle (juce::Slider::TextBoxRight, false, 60, 20);
+    overrunThreshold.setRange (5.0, 100.0, 1.0);
+    overrunThreshold.setTextValueSuffix ("%");
+    overrunThreshold.setValue (monitor.getOverrunThreshold() * 100.0, juce::dontSendNotification);
+    overrunThreshold.onValueChange = [this, &monitor]
+    {
+        monitor.setOverrunThreshold ((float) overrunThreshold.getValue() / 100.0f);
+        monitor.resetStats();
+    };
+    addAndMakeVisible (overrunThreshold);
+
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
-    setSize (400, 300);
+    setSize (1080, analyzerHeight + 3 * knobHeight + choiceHeight + footerHeight);
+    startTimerHz (4);
 }
 
 VonicRewriteAudioProcessorEditor::~VonicRewriteAudioProcessorEditor()
@@ -28,14 +118,108 @@ void VonicRewriteAudioProcessorEditor::paint (juce::Graphics& g)
 {
     // (Our component is opaque, so we must completely fill the background with a solid colour)
     g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
-
-    g.setColour (juce::Colours::white);
-    g.setFont (15.0f);
-    g.drawFittedText ("Hello World!", getLocalBounds(), juce::Justification::centred, 1);
 }
 
 void VonicRewriteAudioProcessorEditor::resized()
 {
-    // This is generally where you'll want to lay out the positions of any
-    // subcomponents in your editor..
+    auto area = getLocalBounds();
+    auto footer = area.removeFromBottom (footerHeight).reduced (8, 4);
+
+    analyzer.setBounds (area.removeFromTop (analyzerHeight));
+    responseCurve.setBounds (analyzer.getBounds());
+
+    auto knobRow = area.removeFromTop (knobHeight);
+    auto knobWidth = knobRow.getWidth() / knobs.size();
+
+    for (auto* knob : knobs)
+    {
+        auto cell = knobRow.removeFromLeft (knobWidth).reduced (4);
+        knob->label.setBounds (cell.removeFromTop (18));
+        knob->slider.setBounds (cell);
+    }
+
+    auto sideRow = area.removeFromTop (knobHeight);
+    auto sideKnobWidth = sideRow.getWidth() / sideKnobs.size();
+
+    for (auto* knob : sideKnobs)
+    {
+        auto cell = sideRow.removeFromLeft (sideKnobWidth).reduced (4);
+        knob->label.setBounds (cell.removeFromTop (18));
+        knob->slider.setBounds (cell);
+    }
+
+    auto choiceRow = area.removeFromTop (choiceHeight);
+    auto choiceWidth = choiceRow.getWidth() / choices.size();
+
+    for (auto* choice : choices)
+    {
+        auto cell = choiceRow.removeFromLeft (choiceWidth).reduced (4, 2);
+        choice->label.setBounds (cell.removeFromTop (18));
+        choice->box.setBounds (cell);
+    }
+
+    auto bandRow = area.removeFromTop (knobHeight);
+    auto bandCellWidth = bandRow.getWidth() / 5;
+    auto pickers = bandRow.removeFromLeft (bandCellWidth * 2).reduced (4);
+
+    bandSelector.setBounds (pickers.removeFromTop (pickers.getHeight() / 2).reduced (0, 8));
+
+    auto typeRow = pickers.reduced (0, 8);
+    bandType->label.setBounds (typeRow.removeFromLeft (typeRow.getWidth() / 3));
+    bandType->box.setBounds (typeRow);
+
+    for (auto* knob : bandKnobs)
+    {
+        auto cell = bandRow.removeFromLeft (bandCellWidth).reduced (4);
+        knob->label.setBounds (cell.removeFromTop (18));
+        knob->slider.setBounds (cell);
+    }
+
+    overrunThreshold.setBounds (footer.removeFromBottom (24).withTrimmedLeft (80));
+    statsLabel.setBounds (footer);
+}
+
+void VonicRewriteAudioProcessorEditor::showBand (int band)
+{
+    // Attachments are tied to one parameter, so re-create the band's controls.
+    bandKnobs.clear();
+    bandType = std::make_unique<ChoiceControl> (audioProcessor.bleh, BandParameters::getParameterID (band, "Type"));
+    addAndMakeVisible (bandType->box);
+    addAndMakeVisible (bandType->label);
+
+    for (auto field : { "Freq", "Gain", "Quality" })
+    {
+        auto* knob = bandKnobs.add (new RotaryControl (audioProcessor.bleh, BandParameters::getParameterID (band, field)));
+        addAndMakeVisible (knob->slider);
+        addAndMakeVisible (knob->label);
+    }
+
+    resized();
+}
+
+void VonicRewriteAudioProcessorEditor::updateDynamicControls()
+{
+    auto cascade = phaseMode->load() < 0.5f && structure->load() < 0.5f;
+
+    for (auto* control : dynamicControls)
+        control->setEnabled (cascade);
+}
+
+void VonicRewriteAudioProcessorEditor::timerCallback()
+{
+    updateDynamicControls();
+
+    auto stats = audioProcessor.getRealtimeMonitor().getStats();
+
+    juce::String text;
+    text << "Block us  min " << juce::String (stats.minMicros, 1)
+         << "  mean " << juce::String (stats.meanMicros, 1)
+         << "  max " << juce::String (stats.maxMicros, 1)
+         << "  p99 " << juce::String (stats.p99Micros, 1)
+         << "  (budget " << juce::String (stats.budgetMicros, 0) << ")\n"
+         << "Overruns " << juce::String (stats.numOverruns) << " / " << juce::String (stats.numBlocks)
+         << "   RT violations " << juce::String (stats.numViolations)
+         << (VONIC_RT_CHECKS ? "" : " (checks off)");
+
+    statsLabel.setText (text, juce::dontSendNotification);
 }
@@ -11,11 +11,14 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "SpectrumAnalyzer.h"
+#include "ResponseCurve.h"
 
 //==============================================================================
 /**
 */
-class VonicRewriteAudioProcessorEditor  : public juce::AudioProcessorEditor
+class VonicRewriteAudioProcessorEditor  : public juce::AudioProcessorEditor,
+                                          private juce::Timer
 {
 public:
     VonicRewriteAudioProcessorEditor (VonicRewriteAudioProcessor&);
@@ -26,9 +29,59 @@ public:
     void resized() override;
 
 private:
+    static constexpr int analyzerHeight = 220, knobHeight = 110, choiceHeight = 48, footerHeight = 80;
+
+    /** A knob or drop-down with its caption, attached to one parameter. */
+    struct RotaryControl
+    {
+        RotaryControl (juce::AudioProcessorValueTreeState& state, const juce::String& parameterID);
+
+        juce::Slider slider;
+        juce::Label label;
+        juce::AudioProcessorValueTreeState::SliderAttachment attachment;
+    };
+
+    struct ChoiceControl
+    {
+        ChoiceControl (juce::AudioProcessorValueTreeState& state, const juce::String& parameterID);
+
+        juce::ComboBox box;
+        juce::Label label;
+        std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> attachment;
+    };
+
+    void timerCallback() override;
+
+    /** Greys out the dynamic peak's controls while the cascade isn't running. */
+    void updateDynamicControls();
+
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
     VonicRewriteAudioProcessor& audioProcessor;
 
+    SpectrumAnalyzer analyzer;
+    ResponseCurve responseCurve;
+    juce::OwnedArray<RotaryControl> knobs;
+    juce::OwnedArray<RotaryControl> sideKnobs;     // the side set of mid/side mode
+    juce::OwnedArray<ChoiceControl> choices;
+
+    // Only the minimum-phase cascade follows the dynamic peak; linear phase
+    // and the parallel form play it static.
+    juce::Array<juce::Component*> dynamicControls;
+    std::atomic<float>* phaseMode;
+    std::atomic<float>* structure;
+
+    // One parametric band at a time, picked with bandSelector.
+    juce::ComboBox bandSelector;
+    std::unique_ptr<ChoiceControl> bandType;
+    juce::OwnedArray<RotaryControl> bandKnobs;
+
+    void showBand (int band);
+
+    // Audio thread health, from the processor's RealtimeMonitor.
+    juce::Label statsLabel;
+    juce::Label thresholdLabel;
+    juce::Slider overrunThreshold;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (VonicRewriteAudioProcessorEditor)
 };
@@ -17,16 +17,31 @@ VonicRewriteAudioProcessor::VonicRewriteAudioProcessor()
                      #if ! JucePlugin_IsMidiEffect
                       #if ! JucePlugin_IsSynth
                        .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                       .withInput  ("Sidechain", juce::AudioChannelSet::stereo(), false)
                       #endif
                        .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
                      #endif
                        )
 #endif
 {
+    bleh.addParameterListener("Oversampling", this);
+    bleh.addParameterListener("OversamplingMode", this);
+    bleh.addParameterListener("PhaseMode", this);
+    bleh.addParameterListener("Structure", this);
+    bleh.addParameterListener("Precision", this);
+    bleh.addParameterListener("Threading", this);
+    channelWorkers.setMonitor(&monitor);
 }
 
 VonicRewriteAudioProcessor::~VonicRewriteAudioProcessor()
 {
+    bleh.removeParameterListener("Oversampling", this);
+    bleh.removeParameterListener("OversamplingMode", this);
+    bleh.removeParameterListener("PhaseMode", this);
+    bleh.removeParameterListener("Structure", this);
+    bleh.removeParameterListener("Precision", this);
+    bleh.removeParameterListener("Threading", this);
+    cancelPendingUpdate();
 }
 
 //==============================================================================
@@ -62,9 +77,46 @@ bool VonicRewriteAudioProcessor::isMidiEffect() const
    #endif
 }
 
+bool VonicRewriteAudioProcessor::supportsDoublePrecisionProcessing() const
+{
+    return true;
+}
+
 double VonicRewriteAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    // Worked out from the published parameters with a designer of its own,
+    // so nothing the audio thread owns is touched.
+    auto hostRate = getSampleRate() > 0.0 ? getSampleRate() : 44100.0;
+    auto latencySeconds = getLatencySamples() / hostRate;
+
+    if (phaseMode->load() > 0.5f && linearPhase.isReady())
+        return 2.0 * latencySeconds;    // the kernel is twice its centre delay
+
+    auto rate = designRate.load();
+    auto settings = snapshot.read();
+    auto bandSettings = bandParams.read();
+
+    CoefficientDesigner tailDesigner;
+    tailDesigner.prepare(rate);
+    tailDesigner.update(settings, allStages);
+
+    std::array<BiquadCoefficients, maxBands> bandSections;
+
+    for (size_t band = 0; band < bandSettings.size(); ++band)
+        if (bandSettings[band].isActive())
+            CoefficientDesigner::designBand(bandSections[band], rate, bandSettings[band]);
+
+    auto decay = getDecaySamples(tailDesigner, settings, bandSettings, bandSections.data());
+
+    // In mid/side mode whichever of the two rings longer sets the tail.
+    if (stereoMode->load() > 0.5f)
+    {
+        auto sideSettings = side.snapshot.read();
+        tailDesigner.update(sideSettings, allStages);
+        decay = juce::jmax(decay, getDecaySamples(tailDesigner, sideSettings, bandSettings, bandSections.data()));
+    }
+
+    return limitTailSeconds(decay, rate) + latencySeconds;
 }
 
 int VonicRewriteAudioProcessor::getNumPrograms()
@@ -98,21 +150,78 @@ void VonicRewriteAudioProcessor::prepareToPlay (double sampleRate, int samplesPe
     // initialisation that you need..
     juce::dsp::ProcessSpec set;
     set.maximumBlockSize = samplesPerBlock;
-    set.numChannels = 1;
+    set.numChannels = (juce::uint32) getMainBusNumOutputChannels();
     set.sampleRate = sampleRate;
-    left.prepare(set);
-    right.prepare(set);
-    auto chainSettings = getFilterSet(bleh);
-    auto peakCoefficients = juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate,chainSettings.peakFreq,chainSettings.peakQual,juce::Decibels::decibelsToGain(chainSettings.peakGain));
-    *left.get<ChainPositions::Peak>().coefficients = *peakCoefficients;
-    *right.get<ChainPositions::Peak>().coefficients = *peakCoefficients;
+    oversampling.prepare(set);
+    linearPhase.prepare(set);
+
+    // The chain has to cope with the largest upsampled block.
+    set.maximumBlockSize *= (juce::uint32) (1 << OversamplingStage::maxFactorIndex);
+
+    forEachChainPair([&set] (auto& pair)
+    {
+        for (auto& c : pair.chains)
+            c.prepare(set);
 
+        pair.fadeBuffer.setSize((int) set.numChannels, (int) set.maximumBlockSize);
+    });
+
+    fadeRemaining = 0;
+
+    // Idle workers stay awake for a block, so they're there for the next one.
+    channelWorkers.setSpinTime(samplesPerBlock / sampleRate);
+    prepared = true;
+    updateChannelWorkers();
+    usingChannelWorkers = false;
+    selectChannelWorkers();
+
+    auto scratchChannels = juce::jmax(getTotalNumInputChannels(), getTotalNumOutputChannels());
+    singleScratch.setSize(scratchChannels, samplesPerBlock);
+    doubleScratch.setSize(scratchChannels, samplesPerBlock);
+    usingDouble = precision->load() > 0.5f;
+    usingSvf = engine->load() > 0.5f;
+    samplesSinceSound = 0;
+    idle = false;
+    dynamicPeak.prepare(sampleRate, samplesPerBlock);
+    dynamicGain = 0.0f;
+
+    hostSampleRate = sampleRate;
+    allocateOversampling();
+    oversampling.select((int) oversamplingFactor->load(), (OversamplingStage::Mode) (int) oversamplingMode->load());
+
+    auto rate = sampleRate * oversampling.getFactor();
+    designRate = rate;
+    designer.prepare(rate);
+    smoothed.prepare(rate, getFilterSet(bleh));
+    side.designer.prepare(rate);
+    side.smoothed.prepare(rate, getFilterSet(bleh, "Side"));
+    side.snapshot.invalidate();
+    side.pendingStages = allStages;
+    usingMidSide = stereoMode->load() > 0.5f && set.numChannels == 2;
+    forEachChainPair([this] (auto& pair)
+    {
+        for (auto& c : pair.chains)
+            c.setMidSide(usingMidSide);
+    });
+    parallel.prepare(set, rate);
+    updateDesigners();
+    usingParallel = false;
+    snapshot.invalidate();
+    bandsInvalid = true;
+    pendingStages = allStages;
+    samplesUntilUpdate = 0;
+    usingLinearPhase = phaseMode->load() > 0.5f && linearPhase.isReady();
+    setLatencySamples(getLatencyForCurrentSettings());
+    monitor.prepare(sampleRate, samplesPerBlock);
 }
 
 void VonicRewriteAudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
+    prepared = false;
+    updateDesigners();
+    updateChannelWorkers();
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -122,12 +231,9 @@ bool VonicRewriteAudioProcessor::isBusesLayoutSupported (const BusesLayout& layo
     juce::ignoreUnused (layouts);
     return true;
   #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // The filter chain sizes itself from the channel count in prepareToPlay,
+    // so anything from mono up to immersive beds (7.1.4 and beyond) is fine.
+    if (layouts.getMainOutputChannelSet().isDisabled())
         return false;
 
     // This checks if the input layout matches the output layout
@@ -136,13 +242,269 @@ bool VonicRewriteAudioProcessor::isBusesLayoutSupported (const BusesLayout& layo
         return false;
    #endif
 
+    // The sidechain only feeds the detector, which sums it to mono, so it
+    // can have any layout or be switched off.
+
     return true;
   #endif
 }
 #endif
 
+void VonicRewriteAudioProcessor::updateChain (const FilterSet& settings, int stages) noexcept
+{
+    // In mid/side mode the side lane gets the side set; otherwise both get
+    // this one. Both designers are current for every stage, so a stage that
+    // moved on either side just loads both again. It only drops out if it
+    // is flat on both, and a dynamic peak never does.
+    auto& sideDesigner = usingMidSide ? side.designer : designer;
+    auto& sideSettings = usingMidSide ? side.smoothed.getCurrent() : settings;
+    auto neutral = getNeutralStages(settings) & getNeutralStages(sideSettings);
+    auto fadeSamples = juce::roundToInt(hostSampleRate * oversampling.getFactor() * bypassFadeSeconds);
+
+    if (dynamicPeak.isEnabled())
+        neutral &= ~peakStage;
+
+    // State-variable sections glide to the new design over the next control slice.
+    auto rampSamples = controlInterval * oversampling.getFactor();
+    auto numLowCut = CoefficientDesigner::getNumSections(settings.lowCutSlope);
+    auto numSideLowCut = CoefficientDesigner::getNumSections(sideSettings.lowCutSlope);
+    auto numHighCut = CoefficientDesigner::getNumSections(settings.highCutSlope);
+    auto numSideHighCut = CoefficientDesigner::getNumSections(sideSettings.highCutSlope);
+
+    forEachChainPair([&] (auto& pair)
+    {
+        auto& chain = *pair.chain;
+
+        if (stages & peakStage)
+        {
+            if (usingSvf)
+                chain.setSvfCoefficients(Peak, &designer.getSvfPeak(), 1, &sideDesigner.getSvfPeak(), 1, rampSamples);
+            else
+                chain.setCoefficients(Peak, &designer.getPeak(), 1, &sideDesigner.getPeak(), 1);
+
+            chain.setBypassed(Peak, (neutral & peakStage) != 0, fadeSamples);
+        }
+
+        if (stages & lowCutStage)
+        {
+            if (usingSvf)
+                chain.setSvfCoefficients(LowCut, designer.getSvfLowCut().data(), numLowCut, sideDesigner.getSvfLowCut().data(), numSideLowCut, rampSamples);
+            else
+                chain.setCoefficients(LowCut, designer.getLowCut().data(), numLowCut, sideDesigner.getLowCut().data(), numSideLowCut);
+
+            chain.setBypassed(LowCut, (neutral & lowCutStage) != 0, fadeSamples);
+        }
+
+        if (stages & highCutStage)
+        {
+            if (usingSvf)
+                chain.setSvfCoefficients(HighCut, designer.getSvfHighCut().data(), numHighCut, sideDesigner.getSvfHighCut().data(), numSideHighCut, rampSamples);
+            else
+                chain.setCoefficients(HighCut, designer.getHighCut().data(), numHighCut, sideDesigner.getHighCut().data(), numSideHighCut);
+
+            chain.setBypassed(HighCut, (neutral & highCutStage) != 0, fadeSamples);
+        }
+    });
+}
+
+void VonicRewriteAudioProcessor::designStages (CoefficientDesigner& target, const FilterSet& settings, int stages) const noexcept
+{
+    if (usingSvf)
+        target.updateSvf(settings, stages);
+    else
+        target.update(settings, stages);
+}
+
+int VonicRewriteAudioProcessor::getNeutralStages (const FilterSet& settings) noexcept
+{
+    // A cut at the very edge of its range still shades the band ends a
+    // little, but that's where a user leaves it to mean "off".
+    auto stages = 0;
+
+    if (std::abs(settings.peakGain) < 0.01f)
+        stages |= peakStage;
+
+    if (settings.lowCutFreq <= 20.f)
+        stages |= lowCutStage;
+
+    if (settings.highCutFreq >= 20000.f)
+        stages |= highCutStage;
+
+    return stages;
+}
+
+void VonicRewriteAudioProcessor::allocateOversampling()
+{
+    // Only the chosen setting gets engines; the audio thread switches once they exist.
+    if (prepared)
+        oversampling.allocate((int) oversamplingFactor->load(), (OversamplingStage::Mode) (int) oversamplingMode->load());
+}
+
+void VonicRewriteAudioProcessor::selectOversampling() noexcept
+{
+    auto mode = (OversamplingStage::Mode) (int) oversamplingMode->load();
+
+    if (! oversampling.select((int) oversamplingFactor->load(), mode))
+        return;
+
+    restartChain();
+}
+
+void VonicRewriteAudioProcessor::selectChannelWorkers() noexcept
+{
+    // No restart needed; a group's state is the same whichever thread runs it.
+    auto wanted = threading->load() > 0.5f && channelWorkers.getNumWorkers() > 0;
+
+    if (wanted == usingChannelWorkers)
+        return;
+
+    usingChannelWorkers = wanted;
+    forEachChainPair([this] (auto& pair)
+    {
+        for (auto& c : pair.chains)
+            c.setWorkers(usingChannelWorkers ? &channelWorkers : nullptr);
+    });
+}
+
+void VonicRewriteAudioProcessor::updateChannelWorkers()
+{
+    // The active chain's register width decides how many groups a block
+    // splits into. One of them always runs on the audio thread.
+    auto lanes = precision->load() > 0.5f ? FilterChain<double>::Register::size()
+                                          : FilterChain<float>::Register::size();
+    auto numGroups = ((size_t) getMainBusNumOutputChannels() + lanes - 1) / lanes;
+    auto numWorkers = prepared && threading->load() > 0.5f && numGroups >= FilterChain<float>::minParallelGroups
+                        ? juce::jmin((int) numGroups, juce::SystemStats::getNumCpus()) - 1 : 0;
+
+    // A failed start isn't retried until the wanted size changes.
+    if (numWorkers == requestedWorkers)
+        return;
+
+    requestedWorkers = numWorkers;
+
+    if (numWorkers > 0)
+        channelWorkers.start(numWorkers);
+    else
+        channelWorkers.stop();
+}
+
+void VonicRewriteAudioProcessor::updateDesigners()
+{
+    // Each background designer only runs while its mode is selected.
+    auto linear = prepared && phaseMode->load() > 0.5f;
+    auto parallelForm = prepared && ! linear && structure->load() > 0.5f;
+    auto current = getFilterSet(bleh);
+
+    linearPhase.setActive(linear, current);
+    parallel.setActive(parallelForm, current);
+}
+
+void VonicRewriteAudioProcessor::restartChain() noexcept
+{
+    // Redesign everything and start the chain from silence, since its
+    // history belongs to the old rate or the other phase mode.
+    auto rate = hostSampleRate * oversampling.getFactor();
+    designRate = rate;
+    parallel.setDesignRate(rate);
+    designer.prepare(rate);
+    smoothed.prepare(rate, snapshot.getCurrent());
+    side.designer.prepare(rate);
+    side.smoothed.prepare(rate, side.snapshot.getCurrent());
+    side.pendingStages = allStages;
+    forEachChainPair([this] (auto& pair)
+    {
+        pair.chain->reset();
+
+        for (auto& c : pair.chains)
+            c.setMidSide(usingMidSide);
+    });
+    fadeRemaining = 0;
+    bandsInvalid = true;
+    pendingStages = allStages;
+    samplesUntilUpdate = 0;
+}
+
+void VonicRewriteAudioProcessor::updateBands() noexcept
+{
+    // A recall's bands arrive with its crossfade; anything after that waits for the fade to end.
+    if (fadeRemaining > 0 || recalled.generation != recallGeneration.load(std::memory_order_acquire))
+        return;
+
+    auto latest = bandParams.read();
+    auto changed = bandsInvalid;
+    auto rate = hostSampleRate * oversampling.getFactor();
+
+    for (size_t band = 0; band < latest.size(); ++band)
+    {
+        if (! bandsInvalid && latest[band] == bands[band])
+            continue;
+
+        if (latest[band].isActive())
+            CoefficientDesigner::designBand(bandCoefficients[band], rate, latest[band]);
+
+        // Bands that stay off don't need the chains touching.
+        changed = changed || latest[band].isActive() || bands[band].isActive();
+    }
+
+    bands = latest;
+    bandsInvalid = false;
+
+    if (! changed)
+        return;
+
+    std::array<int, maxBands> active;
+    int numActive = 0;
+
+    for (int band = 0; band < maxBands; ++band)
+        if (bands[(size_t) band].isActive())
+            active[(size_t) numActive++] = band;
+
+    forEachChainPair([&] (auto& pair)
+    {
+        for (auto& c : pair.chains)
+            c.setBands(bandCoefficients.data(), active.data(), numActive);
+    });
+}
+
+void VonicRewriteAudioProcessor::parameterChanged (const juce::String&, float)
+{
+    triggerAsyncUpdate();
+}
+
+void VonicRewriteAudioProcessor::handleAsyncUpdate()
+{
+    allocateOversampling();
+    updateDesigners();
+    setLatencySamples(getLatencyForCurrentSettings());
+    updateChannelWorkers();
+}
+
+int VonicRewriteAudioProcessor::getLatencyForCurrentSettings() const noexcept
+{
+    // The minimum phase path carries on until the first kernel is in.
+    if (phaseMode->load() > 0.5f && linearPhase.isReady())
+        return linearPhase.getLatencySamples();
+
+    auto mode = (OversamplingStage::Mode) (int) oversamplingMode->load();
+    return oversampling.getLatencySamples((int) oversamplingFactor->load(), mode);
+}
+
 void VonicRewriteAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    juce::ignoreUnused(midiMessages);
+    process(buffer);
+}
+
+void VonicRewriteAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused(midiMessages);
+    process(buffer);
+}
+
+template <typename HostType>
+void VonicRewriteAudioProcessor::process (juce::AudioBuffer<HostType>& buffer) noexcept
+{
+    RealtimeMonitor::ScopedBlock monitorScope (monitor, buffer.getNumSamples());
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -156,113 +518,447 @@ void VonicRewriteAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-    auto chainSettings = getFilterSet(bleh);
-    auto peakCoefficients = juce::dsp::IIR::Coefficients<float>::makePeakFilter(getSampleRate(),chainSettings.peakFreq,chainSettings.peakQual,juce::Decibels::decibelsToGain(chainSettings.peakGain));
+    selectOversampling();
+    selectChannelWorkers();
 
-    auto cutCoefficients = juce::dsp::FilterDesign<float>::designIIRHighpassHighOrderButterworthMethod(chainSettings.lowCutFreq,getSampleRate(),(chainSettings.lowCutSlope+1)*2);
-    
-    *left.get<ChainPositions::Peak>().coefficients = *peakCoefficients;
-    *right.get<ChainPositions::Peak>().coefficients = *peakCoefficients;
-    auto& leftLowCut = left.get<ChainPositions::LowCut>();
+    // Only touch the stages whose knobs actually moved. They glide to the new
+    // values rather than jumping, and a slope change lands on the next tick.
+    if (auto changes = snapshot.update())
+    {
+        smoothed.setTarget(snapshot.getCurrent(), changes);
+        pendingStages |= changes;
+        samplesUntilUpdate = 0;
+    }
+
+    if (auto changes = side.snapshot.update())
+    {
+        side.smoothed.setTarget(side.snapshot.getCurrent(), changes);
+        side.pendingStages |= changes;
+        samplesUntilUpdate = 0;
+    }
+
+    if (handover.fetch(recalled))
+        startCrossfade();
+
+    updateBands();
+
+    // Only the main bus is processed; the sidechain, when there is one, is just for the detector.
+    auto mainBus = getBusBuffer(buffer, false, 0);
+    juce::dsp::AudioBlock<HostType> block(mainBus);
+    auto analyzing = analyzerEnabled.load(std::memory_order_relaxed);
+
+    if (analyzing)
+        preAnalyzer.push(block);
+
+    // Linear phase replaces the whole minimum-phase path once its first
+    // kernel is in; its own thread follows the snapshot and the convolution
+    // crossfades kernel changes.
+    auto linear = phaseMode->load() > 0.5f && linearPhase.isReady();
+    parallel.setEnabled(! linear && structure->load() > 0.5f);
+
+    // Mid/side needs a stereo pair and the cascade. Switching restarts the
+    // chain, since its history is in the other encoding.
+    auto midSide = stereoMode->load() > 0.5f && block.getNumChannels() == 2;
+
+    if (midSide != usingMidSide)
+    {
+        usingMidSide = midSide;
+        restartChain();
+    }
+
+    if (linear != usingLinearPhase)
+    {
+        usingLinearPhase = linear;
+
+        if (linear)
+            linearPhase.reset();
+        else
+            restartChain();
+    }
+
+    // The parallel form takes over from the cascade whenever it has a valid
+    // design for this rate, but not in the middle of a recall's crossfade.
+    // Switching either way starts the new structure from silence.
+    auto useParallel = ! linear && ! midSide && fadeRemaining == 0 && structure->load() > 0.5f
+                       && parallel.update(hostSampleRate * oversampling.getFactor());
+
+    if (useParallel != usingParallel)
+    {
+        usingParallel = useParallel;
+
+        if (useParallel)
+            parallel.reset();
+        else
+            restartChain();
+    }
 
+    // Switching engine starts the chain again from silence; the two keep
+    // their state in different forms.
+    auto wantSvf = engine->load() > 0.5f;
 
-    leftLowCut.setBypassed<0>(true);
-    leftLowCut.setBypassed<1>(true);
-    leftLowCut.setBypassed<2>(true);
-    leftLowCut.setBypassed<3>(true);
+    if (wantSvf != usingSvf)
+    {
+        usingSvf = wantSvf;
+        restartChain();
+    }
 
-    switch(chainSettings.lowCutSlope)
+    // Internal precision is independent of what the host hands us; the
+    // history of the other precision's chain and oversampler is stale.
+    auto wantDouble = precision->load() > 0.5f;
+
+    if (wantDouble != usingDouble)
     {
-        case grad12:
+        usingDouble = wantDouble;
+        restartChain();
+        oversampling.reset();
+    }
+
+    if (skipIfIdle(block))
+    {
+        if (analyzing)
+            postAnalyzer.push(block);
+
+        return;
+    }
+
+    // The detector runs at the host rate on the block before it is processed.
+    if (dynamicPeak.update(snapshot.getCurrent().peakFreq, snapshot.getCurrent().peakQual))
+    {
+        auto* sidechain = getBusCount(true) > 1 ? getBus(true, 1) : nullptr;
+
+        if (dynamicPeak.wantsSidechain() && sidechain != nullptr && sidechain->isEnabled())
         {
-            *leftLowCut.get<0>().coefficients = *cutCoefficients[0];
-            leftLowCut.setBypassed<0>(false);
-            break;
+            auto sidechainBus = getBusBuffer(buffer, true, 1);
+            dynamicPeak.analyse(juce::dsp::AudioBlock<const HostType>(sidechainBus));
         }
-        case grad24:
+        else
         {
-            *leftLowCut.get<0>().coefficients = *cutCoefficients[0];
-            leftLowCut.setBypassed<0>(false);
-            *leftLowCut.get<1>().coefficients = *cutCoefficients[1];
-            leftLowCut.setBypassed<1>(false);
-            break;
-        }
-        case grad36:{
-            *leftLowCut.get<0>().coefficients = *cutCoefficients[0];
-            leftLowCut.setBypassed<0>(false);
-            *leftLowCut.get<1>().coefficients = *cutCoefficients[1];
-            leftLowCut.setBypassed<1>(false);
-            *leftLowCut.get<2>().coefficients = *cutCoefficients[2];
-            leftLowCut.setBypassed<2>(false);
-            break;
+            dynamicPeak.analyse(block);
         }
-        case grad48:
+    }
+
+    // Linear phase and the parallel form only run in single precision.
+    if (linear)
+    {
+        processAs<float>(block, [this] (auto& b) { linearPhase.process(b); });
+    }
+    else if (useParallel)
+    {
+        processAs<float>(block, [this] (auto& b)
         {
-            *leftLowCut.get<0>().coefficients = *cutCoefficients[0];
-            leftLowCut.setBypassed<0>(false);
-            *leftLowCut.get<1>().coefficients = *cutCoefficients[1];
-            leftLowCut.setBypassed<1>(false);
-            *leftLowCut.get<2>().coefficients = *cutCoefficients[2];
-            leftLowCut.setBypassed<2>(false);
-            *leftLowCut.get<3>().coefficients = *cutCoefficients[3];
-            leftLowCut.setBypassed<3>(false);
-            break;
-        }
+            auto upsampled = oversampling.processUp(b);
+            parallel.process(upsampled);
+            oversampling.processDown(b);
+        });
     }
-    auto& rightLowCut = right.get<ChainPositions::LowCut>();
-    rightLowCut.setBypassed<0>(true);
-    rightLowCut.setBypassed<1>(true);
-    rightLowCut.setBypassed<2>(true);
-    rightLowCut.setBypassed<3>(true);
+    else
+    {
+        auto runCascade = [this] (auto& b, auto& pair)
+        {
+            auto upsampled = oversampling.processUp(b);
+            processChain(upsampled, pair);
+            oversampling.processDown(b);
+        };
 
-    switch(chainSettings.lowCutSlope)
+        if (usingDouble)
+            processAs<double>(block, [&] (auto& b) { runCascade(b, doubleChains); });
+        else
+            processAs<float>(block, [&] (auto& b) { runCascade(b, singleChains); });
+    }
+
+    if (analyzing)
+        postAnalyzer.push(block);
+}
+
+template <typename HostType>
+bool VonicRewriteAudioProcessor::skipIfIdle (const juce::dsp::AudioBlock<HostType>& block) noexcept
+{
+    auto silent = true;
+
+    for (size_t channel = 0; channel < block.getNumChannels() && silent; ++channel)
+    {
+        auto range = juce::FloatVectorOperations::findMinAndMax(block.getChannelPointer(channel), (int) block.getNumSamples());
+        silent = range.getStart() > (HostType) -silenceThreshold && range.getEnd() < (HostType) silenceThreshold;
+    }
+
+    if (! silent)
     {
-        case grad12:
+        // Everything had rung out, so carry on from silence, with the
+        // smoothers jumped to wherever the knobs are now.
+        if (idle)
         {
-            *rightLowCut.get<0>().coefficients = *cutCoefficients[0];
-            rightLowCut.setBypassed<0>(false);
-            break;
+            idle = false;
+            restartChain();
+            oversampling.reset();
+            parallel.reset();
+            linearPhase.reset();
+            dynamicPeak.reset();
         }
-        case grad24:
+
+        samplesSinceSound = 0;
+        return false;
+    }
+
+    // Measured from the last sound, with whatever design was running then.
+    if (samplesSinceSound == 0)
+        tailSamples = getTailSamples();
+
+    samplesSinceSound += (juce::int64) block.getNumSamples();
+    idle = samplesSinceSound > tailSamples;
+    return idle;
+}
+
+juce::int64 VonicRewriteAudioProcessor::getTailSamples() const noexcept
+{
+    auto latency = getLatencyForCurrentSettings();
+
+    if (usingLinearPhase)
+        return 2 * (juce::int64) latency;
+
+    // The parallel form has the same poles as the cascade.
+    // The state-variable engine has the same poles as the biquads would;
+    // design those on a copy, so the live designers aren't touched.
+    auto biquads = [this] (const CoefficientDesigner& d, const FilterSet& settings)
+    {
+        auto copy = d;
+
+        if (usingSvf)
+            copy.update(settings, allStages);
+
+        return copy;
+    };
+
+    auto decay = getDecaySamples(biquads(designer, smoothed.getCurrent()), smoothed.getCurrent(), bands, bandCoefficients.data());
+
+    if (usingMidSide)
+        decay = juce::jmax(decay, getDecaySamples(biquads(side.designer, side.smoothed.getCurrent()), side.smoothed.getCurrent(), bands, bandCoefficients.data()));
+
+    auto seconds = limitTailSeconds(decay, hostSampleRate * oversampling.getFactor());
+    return (juce::int64) std::ceil(seconds * hostSampleRate) + latency;
+}
+
+double VonicRewriteAudioProcessor::limitTailSeconds (double decaySamples, double rate) noexcept
+{
+    auto seconds = decaySamples / rate;
+    return std::isfinite(seconds) ? juce::jlimit(0.0, maxTailSeconds, seconds) : maxTailSeconds;
+}
+
+double VonicRewriteAudioProcessor::getDecaySamples (const CoefficientDesigner& cuts, const FilterSet& settings,
+                                                    const BandSet& bandSettings, const BiquadCoefficients* bandSections) noexcept
+{
+    auto samples = CoefficientDesigner::getDecaySamples(cuts.getPeak(), silenceDecibels);
+
+    for (int i = 0; i < CoefficientDesigner::getNumSections(settings.lowCutSlope); ++i)
+        samples += CoefficientDesigner::getDecaySamples(cuts.getLowCut()[(size_t) i], silenceDecibels);
+
+    for (int i = 0; i < CoefficientDesigner::getNumSections(settings.highCutSlope); ++i)
+        samples += CoefficientDesigner::getDecaySamples(cuts.getHighCut()[(size_t) i], silenceDecibels);
+
+    for (size_t band = 0; band < bandSettings.size(); ++band)
+        if (bandSettings[band].isActive())
+            samples += CoefficientDesigner::getDecaySamples(bandSections[band], silenceDecibels);
+
+    return samples;
+}
+
+template <typename SampleType, typename HostType, typename Fn>
+void VonicRewriteAudioProcessor::processAs (juce::dsp::AudioBlock<HostType>& block, Fn&& fn) noexcept
+{
+    if constexpr (std::is_same_v<SampleType, HostType>)
+    {
+        fn(block);
+    }
+    else
+    {
+        auto& scratch = [this]() -> juce::AudioBuffer<SampleType>&
+        {
+            if constexpr (std::is_same_v<SampleType, float>)
+                return singleScratch;
+            else
+                return doubleScratch;
+        }();
+
+        const auto numChannels = block.getNumChannels();
+        const auto numSamples = block.getNumSamples();
+        auto converted = juce::dsp::AudioBlock<SampleType>(scratch).getSubsetChannelBlock(0, numChannels).getSubBlock(0, numSamples);
+
+        for (size_t channel = 0; channel < numChannels; ++channel)
         {
-            *rightLowCut.get<0>().coefficients = *cutCoefficients[0];
-            rightLowCut.setBypassed<0>(false);
-            *rightLowCut.get<1>().coefficients = *cutCoefficients[1];
-            rightLowCut.setBypassed<1>(false);
-            break;
+            auto* src = block.getChannelPointer(channel);
+            std::copy(src, src + numSamples, converted.getChannelPointer(channel));
         }
-        case grad36:{
-            *rightLowCut.get<0>().coefficients = *cutCoefficients[0];
-            rightLowCut.setBypassed<0>(false);
-            *rightLowCut.get<1>().coefficients = *cutCoefficients[1];
-            rightLowCut.setBypassed<1>(false);
-            *rightLowCut.get<2>().coefficients = *cutCoefficients[2];
-            rightLowCut.setBypassed<2>(false);
-            break;
+
+        fn(converted);
+
+        for (size_t channel = 0; channel < numChannels; ++channel)
+        {
+            auto* src = converted.getChannelPointer(channel);
+            std::copy(src, src + numSamples, block.getChannelPointer(channel));
         }
-        case grad48:
+    }
+}
+
+void VonicRewriteAudioProcessor::startCrossfade() noexcept
+{
+    // Designed for another rate (or we're in linear phase, which follows the
+    // snapshot by itself): just let the normal path catch up.
+    if (usingLinearPhase || usingParallel || usingMidSide || usingSvf || recalled.sampleRate != hostSampleRate * oversampling.getFactor() || fadeRemaining > 0)
+    {
+        pendingStages = allStages;
+        return;
+    }
+
+    forEachChainPair([this] (auto& pair)
+    {
+        pair.incoming->reset();
+        pair.incoming->setCoefficients(LowCut, recalled.lowCut.data(), CoefficientDesigner::getNumSections(recalled.settings.lowCutSlope));
+        pair.incoming->setCoefficients(Peak, &recalled.peak, 1);
+        pair.incoming->setCoefficients(HighCut, recalled.highCut.data(), CoefficientDesigner::getNumSections(recalled.settings.highCutSlope));
+
+        auto neutral = getNeutralStages(recalled.settings);
+        pair.incoming->setBypassed(LowCut, (neutral & lowCutStage) != 0, 0);
+        pair.incoming->setBypassed(Peak, (neutral & peakStage) != 0, 0);
+        pair.incoming->setBypassed(HighCut, (neutral & highCutStage) != 0, 0);
+    });
+
+    // The bands only go into the incoming chain; the outgoing one keeps what it had.
+    std::array<int, maxBands> active;
+    int numActive = 0;
+
+    for (int band = 0; band < maxBands; ++band)
+        if (recalled.bands[(size_t) band].isActive())
+            active[(size_t) numActive++] = band;
+
+    forEachChainPair([&] (auto& pair)
+    {
+        pair.incoming->setBands(recalled.bandSections.data(), active.data(), numActive);
+    });
+
+    bands = recalled.bands;
+    bandCoefficients = recalled.bandSections;
+    bandsInvalid = false;
+
+    // Jump straight to the recalled settings; only what has moved on since
+    // the recall was designed still needs doing here.
+    smoothed.prepare(recalled.sampleRate, recalled.settings);
+    dynamicGain = 0.0f;
+    pendingStages = snapshot.getCurrent().getChangedStages(recalled.settings);
+    samplesUntilUpdate = 0;
+
+    fadeLength = fadeRemaining = juce::jmax(1, juce::roundToInt(recalled.sampleRate * crossfadeSeconds));
+}
+
+template <typename SampleType>
+void VonicRewriteAudioProcessor::processCrossfade (juce::dsp::AudioBlock<SampleType>& block, ChainPair<SampleType>& pair) noexcept
+{
+    const auto numSamples = block.getNumSamples();
+    auto faded = juce::dsp::AudioBlock<SampleType>(pair.fadeBuffer).getSubsetChannelBlock(0, block.getNumChannels()).getSubBlock(0, numSamples);
+    faded.copyFrom(block);
+
+    pair.chain->process(juce::dsp::ProcessContextReplacing<SampleType>(block));
+    pair.incoming->process(juce::dsp::ProcessContextReplacing<SampleType>(faded));
+
+    // Both chains see the same input, so a linear fade keeps the level steady.
+    const auto start = fadeLength - fadeRemaining;
+
+    for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+    {
+        auto* out = block.getChannelPointer(channel);
+        auto* in = faded.getChannelPointer(channel);
+
+        for (size_t i = 0; i < numSamples; ++i)
         {
-            *rightLowCut.get<0>().coefficients = *cutCoefficients[0];
-            rightLowCut.setBypassed<0>(false);
-            *rightLowCut.get<1>().coefficients = *cutCoefficients[1];
-            rightLowCut.setBypassed<1>(false);
-            *rightLowCut.get<2>().coefficients = *cutCoefficients[2];
-            rightLowCut.setBypassed<2>(false);
-            *rightLowCut.get<3>().coefficients = *cutCoefficients[3];
-            rightLowCut.setBypassed<3>(false);
-            break;
+            auto mix = juce::jmin((SampleType) 1, (SampleType) (start + (int) i) / (SampleType) fadeLength);
+            out[i] += mix * (in[i] - out[i]);
         }
     }
-    juce::dsp::AudioBlock<float> block(buffer);
-    auto leftBlock = block.getSingleChannelBlock(0);
-    auto rightBlock = block.getSingleChannelBlock(1);
 
-    juce::dsp::ProcessContextReplacing<float> leftContext(leftBlock);
-    juce::dsp::ProcessContextReplacing<float> rightContext(rightBlock);
+    fadeRemaining -= (int) numSamples;
+
+    if (fadeRemaining <= 0)
+    {
+        fadeRemaining = 0;
+
+        // The other precision's pair was loaded with the same recall.
+        forEachChainPair([] (auto& p) { std::swap(p.chain, p.incoming); });
+    }
+}
+
+template <typename SampleType>
+void VonicRewriteAudioProcessor::processChain (juce::dsp::AudioBlock<SampleType>& block, ChainPair<SampleType>& pair) noexcept
+{
+    // Parameter changes wait for a recall's crossfade to finish.
+    if (fadeRemaining > 0)
+    {
+        processCrossfade(block, pair);
+        return;
+    }
+
+    // Every channel goes through the chain together, packed into SIMD lanes.
+    auto sideSettled = ! usingMidSide || (side.pendingStages == 0 && ! side.smoothed.isSmoothing());
 
-    left.process(leftContext);
-    right.process(rightContext);
+    if (pendingStages == 0 && ! smoothed.isSmoothing() && sideSettled && ! dynamicPeak.isEnabled() && dynamicGain == 0.0f)
+    {
+        pair.chain->process(juce::dsp::ProcessContextReplacing<SampleType>(block));
+        return;
+    }
+
+    // While anything is ramping, run in control-rate slices and redesign the
+    // moving stages between them. The designer writes into fixed storage so
+    // none of this allocates on the audio thread. The slices are a fixed
+    // length in host samples, whatever the oversampling factor. A dynamic
+    // peak redesigns on the same ticks, once its offset has moved audibly.
+    const auto numSamples = block.getNumSamples();
+    const auto factor = oversampling.getFactor();
+    const auto interval = controlInterval * factor;
+
+    for (size_t position = 0; position < numSamples;)
+    {
+        if (samplesUntilUpdate == 0)
+        {
+            auto stages = pendingStages | smoothed.advance(interval);
+            pendingStages = 0;
+
+            // The side set only matters in mid/side mode; restartChain flags
+            // all of it when the mode comes on.
+            if (usingMidSide)
+            {
+                auto sideStages = side.pendingStages | side.smoothed.advance(interval);
+                side.pendingStages = 0;
+
+                if (sideStages != 0)
+                    designStages(side.designer, side.smoothed.getCurrent(), sideStages);
+
+                stages |= sideStages;
+            }
 
+            auto offset = dynamicPeak.getGainOffset(position / (size_t) factor);
+
+            if (std::abs(offset - dynamicGain) > dynamicGainStep || (offset == 0.0f && dynamicGain != 0.0f))
+            {
+                dynamicGain = offset;
+                stages |= peakStage;
+            }
+
+            if (stages != 0)
+            {
+                auto settings = smoothed.getCurrent();
+                settings.peakGain += dynamicGain;
+
+                designStages(designer, settings, stages);
+                updateChain(settings, stages);
+            }
+
+            samplesUntilUpdate = interval;
+        }
+
+        auto length = juce::jmin((size_t) samplesUntilUpdate, numSamples - position);
+        auto slice = block.getSubBlock(position, length);
+        pair.chain->process(juce::dsp::ProcessContextReplacing<SampleType>(slice));
+
+        position += length;
+        samplesUntilUpdate -= (int) length;
+    }
 }
 
 //==============================================================================
@@ -273,40 +969,63 @@ bool VonicRewriteAudioProcessor::hasEditor() const
 
 juce::AudioProcessorEditor* VonicRewriteAudioProcessor::createEditor()
 {
- //   return new VonicRewriteAudioProcessorEditor (*this);
-    return new juce::GenericAudioProcessorEditor(*this);
+    return new VonicRewriteAudioProcessorEditor (*this);
 }
 
 //==============================================================================
 void VonicRewriteAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
+    // A small header, then the parameter tree in ValueTree's own binary
+    // format, which is far smaller and quicker to parse than XML.
+    juce::MemoryOutputStream stream(destData, false);
+    stream.writeInt(stateMagic);
+    stream.writeInt(stateVersion);
+    bleh.copyState().writeToStream(stream);
 }
 
 void VonicRewriteAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
-    
+    juce::MemoryInputStream stream(data, (size_t) sizeInBytes, false);
+
+    if (sizeInBytes < 8 || stream.readInt() != stateMagic)
+        return;
+
+    // Version 1 is the only format so far. A newer one may mean something
+    // else by the same properties, so leave the current state alone.
+    auto version = stream.readInt();
+
+    if (version < 1 || version > stateVersion)
+        return;
+
+    auto tree = juce::ValueTree::readFromStream(stream);
+
+    if (! tree.hasType(bleh.state.getType()))
+        return;
+
+    auto generation = ++recallGeneration;
+    bleh.replaceState(tree);
+
+    // Design the recalled settings here rather than on the audio thread,
+    // which crossfades over to them as soon as it picks them up.
+    handover.post(getFilterSet(bleh), bandParams.read(), designRate.load(), generation);
 }
-FilterSet getFilterSet(juce::AudioProcessorValueTreeState& bleh){
+
+FilterSet getFilterSet(juce::AudioProcessorValueTreeState& bleh, const juce::String& prefix){
     FilterSet props;
 
-    props.lowCutFreq = bleh.getRawParameterValue("HighPass")->load();
-    props.highCutFreq = bleh.getRawParameterValue("LowPass")->load();
-    props.peakFreq = bleh.getRawParameterValue("Peak")->load();
-    props.peakGain = bleh.getRawParameterValue("Gain")->load();
-    props.peakQual = bleh.getRawParameterValue("Quality")->load();
-    props.lowCutSlope = static_cast<Gradient>(bleh.getRawParameterValue("HighPassGrad")->load());
-    props.highCutSlope = static_cast<Gradient>(bleh.getRawParameterValue("LowPassGrad")->load());
+    props.lowCutFreq = bleh.getRawParameterValue(prefix + "HighPass")->load();
+    props.highCutFreq = bleh.getRawParameterValue(prefix + "LowPass")->load();
+    props.peakFreq = bleh.getRawParameterValue(prefix + "Peak")->load();
+    props.peakGain = bleh.getRawParameterValue(prefix + "Gain")->load();
+    props.peakQual = bleh.getRawParameterValue(prefix + "Quality")->load();
+    props.lowCutSlope = static_cast<Gradient>(bleh.getRawParameterValue(prefix + "HighPassGrad")->load());
+    props.highCutSlope = static_cast<Gradient>(bleh.getRawParameterValue(prefix + "LowPassGrad")->load());
     return props;
 }
 juce::AudioProcessorValueTreeState::ParameterLayout VonicRewriteAudioProcessor::createParams(){
         juce::AudioProcessorValueTreeState::ParameterLayout map;
         map.add(std::make_unique<juce::AudioParameterFloat>("HighPass","HighPass",juce::NormalisableRange<float>(20.f,20000.f,1.f,1.f),20.f));
-        map.add(std::make_unique<juce::AudioParameterFloat>("LowPass","LowPass",juce::NormalisableRange<float>(20.f,20000.f,1.f,1.f),20.f));
+        map.add(std::make_unique<juce::AudioParameterFloat>("LowPass","LowPass",juce::NormalisableRange<float>(20.f,20000.f,1.f,1.f),20000.f));
         map.add(std::make_unique<juce::AudioParameterFloat>("Peak","Peak",juce::NormalisableRange<float>(20.f,20000.f,1.f,1.f),750.f));
         map.add(std::make_unique<juce::AudioParameterFloat>("Gain","Gain",juce::NormalisableRange<float>(-24.f,24.f,0.5f,1.f),0.f));
         map.add(std::make_unique<juce::AudioParameterFloat>("Quality","Quality",juce::NormalisableRange<float>(0.1f,10.f,0.05f,1.f),1.f));
@@ -323,6 +1042,39 @@ juce::AudioProcessorValueTreeState::ParameterLayout VonicRewriteAudioProcessor::
     map.add(std::make_unique<juce::AudioParameterChoice>("HighPassGrad","HighPassGrad",choices,0));
     map.add(std::make_unique<juce::AudioParameterChoice>("LowPassGrad","LowPassGrad",choices,0));
 
+    // The side half of mid/side mode; the set above works on mid.
+    map.add(std::make_unique<juce::AudioParameterFloat>("SideHighPass","SideHighPass",juce::NormalisableRange<float>(20.f,20000.f,1.f,1.f),20.f));
+    map.add(std::make_unique<juce::AudioParameterFloat>("SideLowPass","SideLowPass",juce::NormalisableRange<float>(20.f,20000.f,1.f,1.f),20000.f));
+    map.add(std::make_unique<juce::AudioParameterFloat>("SidePeak","SidePeak",juce::NormalisableRange<float>(20.f,20000.f,1.f,1.f),750.f));
+    map.add(std::make_unique<juce::AudioParameterFloat>("SideGain","SideGain",juce::NormalisableRange<float>(-24.f,24.f,0.5f,1.f),0.f));
+    map.add(std::make_unique<juce::AudioParameterFloat>("SideQuality","SideQuality",juce::NormalisableRange<float>(0.1f,10.f,0.05f,1.f),1.f));
+    map.add(std::make_unique<juce::AudioParameterChoice>("SideHighPassGrad","SideHighPassGrad",choices,0));
+    map.add(std::make_unique<juce::AudioParameterChoice>("SideLowPassGrad","SideLowPassGrad",choices,0));
+
+    BandParameters::addParameters(map);
+    DynamicBand::addParameters(map);
+
+    // Changing either of these changes the latency, so keep them out of automation.
+    auto notAutomatable = juce::AudioParameterChoiceAttributes().withAutomatable(false);
+    map.add(std::make_unique<juce::AudioParameterChoice>("Oversampling","Oversampling",OversamplingStage::getFactorNames(),0,notAutomatable));
+    map.add(std::make_unique<juce::AudioParameterChoice>("OversamplingMode","OversamplingMode",OversamplingStage::getModeNames(),0,notAutomatable));
+    map.add(std::make_unique<juce::AudioParameterChoice>("PhaseMode","PhaseMode",juce::StringArray{"Minimum phase","Linear phase"},0,notAutomatable));
+
+    // No latency change here, but switching restarts the filter state.
+    map.add(std::make_unique<juce::AudioParameterChoice>("Structure","Structure",juce::StringArray{"Series","Parallel"},0,notAutomatable));
+
+    // Internal precision of the cascade, whatever the host's sample type.
+    map.add(std::make_unique<juce::AudioParameterChoice>("Precision","Precision",juce::StringArray{"Single","Double"},0,notAutomatable));
+
+    // Biquads or state-variable sections for the cascade; switching restarts it.
+    map.add(std::make_unique<juce::AudioParameterChoice>("Engine","Engine",juce::StringArray{"Biquad","State variable"},0,notAutomatable));
+
+    // Switching restarts the filter state as well.
+    map.add(std::make_unique<juce::AudioParameterChoice>("StereoMode","StereoMode",juce::StringArray{"Stereo","Mid/Side"},0,notAutomatable));
+
+    // Spreads wide layouts over a few threads; the output is the same either way.
+    map.add(std::make_unique<juce::AudioParameterChoice>("Threading","Threading",juce::StringArray{"Serial","Parallel"},0,notAutomatable));
+
     
     
     return map;
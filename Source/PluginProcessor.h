@@ -10,24 +10,30 @@
 #pragma once
 
 #include <JuceHeader.h>
-enum Gradient{
-  grad12,
-  grad24,
-  grad36,
-  grad48
-};
-struct FilterSet{
-  float peakFreq {0},peakGain{0},peakQual{1.f};
-  float lowCutFreq {0},highCutFreq {0};
-  Gradient lowCutSlope {Gradient::grad12},highCutSlope{Gradient::grad12};
-};
+#include "FilterSet.h"
+#include "CoefficientDesigner.h"
+#include "FilterChain.h"
+#include "ParameterSnapshot.h"
+#include "RealtimeMonitor.h"
+#include "SmoothedFilterSet.h"
+#include "OversamplingStage.h"
+#include "LinearPhaseEngine.h"
+#include "ParallelFormFilter.h"
+#include "AnalyzerFifo.h"
+#include "CoefficientHandover.h"
+#include "BandParameters.h"
+#include "DynamicBand.h"
+#include "ChannelWorkers.h"
 
-ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& bleh);
+/** Reads a FilterSet straight from the parameters; prefix "Side" gives the mid/side side set. */
+FilterSet getFilterSet(juce::AudioProcessorValueTreeState& bleh, const juce::String& prefix = {});
 
 //==============================================================================
 /**
 */
-class VonicRewriteAudioProcessor  : public juce::AudioProcessor
+class VonicRewriteAudioProcessor  : public juce::AudioProcessor,
+                                    private juce::AudioProcessorValueTreeState::Listener,
+                                    private juce::AsyncUpdater
                             #if JucePlugin_Enable_ARA
                              , public juce::AudioProcessorARAExtension
                             #endif
@@ -46,6 +52,8 @@ public:
    #endif
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override;
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -71,16 +79,192 @@ public:
     void setStateInformation (const void* data, int sizeInBytes) override;
     juce::AudioProcessorValueTreeState::ParameterLayout createParams();
     juce::AudioProcessorValueTreeState bleh{*this,nullptr,"HOHO",createParams()};
+
+    RealtimeMonitor& getRealtimeMonitor() noexcept { return monitor; }
+
+    /** The rate the filters are designed at: the host rate times the oversampling factor. */
+    double getDesignRate() const noexcept { return designRate.load(); }
+
+    /** The spectrum analyzer turns the feed on while it is open; otherwise processBlock skips it. */
+    void setAnalyzerEnabled (bool shouldFeed) noexcept { analyzerEnabled = shouldFeed; }
+    AnalyzerFifo& getAnalyzerFifo (bool postEq) noexcept { return postEq ? postAnalyzer : preAnalyzer; }
 private:
-    using Filter = juce::dsp::IIR::Filter<float>;
-    using CutFilter = juce::dsp::ProcessorChain<Filter,Filter,Filter,Filter>;
-    using MonoChain = juce::dsp::ProcessorChain<CutFilter,Filter,CutFilter>;
-    MonoChain left,right;
-    enum ChainPositions{
-      LowCut,
-      Peak,
-      HighCut
+    RealtimeMonitor monitor;
+
+    // Normally only *chain runs. A recalled preset is loaded into *incoming
+    // and crossfaded in, then the two pointers are swapped.
+    template <typename SampleType>
+    struct ChainPair
+    {
+        std::array<FilterChain<SampleType>, 2> chains;
+        FilterChain<SampleType>* chain = &chains[0];
+        FilterChain<SampleType>* incoming = &chains[1];
+        juce::AudioBuffer<SampleType> fadeBuffer;
+    };
+
+    // One pair per internal precision. Both always hold the same coefficients,
+    // so switching precision needs no redesign, only a reset.
+    ChainPair<float> singleChains;
+    ChainPair<double> doubleChains;
+    std::atomic<float>* precision = bleh.getRawParameterValue("Precision");
+    bool usingDouble = false;
+
+    // For when the host's sample type isn't the one a path runs in.
+    juce::AudioBuffer<float> singleScratch;
+    juce::AudioBuffer<double> doubleScratch;
+    ParameterSnapshot snapshot{bleh};
+    CoefficientDesigner designer;
+
+    // Coefficients follow the smoothed settings every controlInterval samples,
+    // counted across blocks so the rate doesn't depend on the host's buffer size.
+    static constexpr int controlInterval = 32;
+    SmoothedFilterSet smoothed;
+    int pendingStages = 0;
+    int samplesUntilUpdate = 0;
+
+    // The parametric bands are read once per block and redesigned only when
+    // one of them changes; both chains get the same set.
+    BandParameters bandParams{bleh};
+    BandSet bands;
+    std::array<BiquadCoefficients, maxBands> bandCoefficients;
+    bool bandsInvalid = true;
+
+    // The cascade runs either biquads or state-variable sections. The latter
+    // glide per sample between control ticks, so sweeps and the dynamic peak
+    // move without zipper steps. Recalls redesign directly instead of crossfading.
+    std::atomic<float>* engine = bleh.getRawParameterValue("Engine");
+    bool usingSvf = false;
+
+    // Mid/side mode runs the main set on mid and this one on side, in the
+    // cascade only; linear phase and the parallel form stay left/right.
+    // The side set follows the same smoothing and control ticks as the main one.
+    struct SideFilters
+    {
+        explicit SideFilters (juce::AudioProcessorValueTreeState& state) : snapshot (state, "Side") {}
+
+        ParameterSnapshot snapshot;
+        CoefficientDesigner designer;
+        SmoothedFilterSet smoothed;
+        int pendingStages = 0;
     };
+
+    SideFilters side{bleh};
+    std::atomic<float>* stereoMode = bleh.getRawParameterValue("StereoMode");
+    bool usingMidSide = false;
+
+    // In dynamic mode the peak's gain is pulled down by the detector's offset
+    // at each control tick; dynamicGain is the offset currently designed in.
+    // Only the cascade follows it; linear phase and the parallel form stay static.
+    DynamicBand dynamicPeak{bleh};
+    float dynamicGain = 0.0f;
+    static constexpr float dynamicGainStep = 0.05f;
+
+    // Wide layouts can spread the cascade's channel groups over a few helper
+    // threads. The message thread only keeps them running while prepared,
+    // with "Threading" on and enough groups of the active precision and
+    // cores to spare. The chains still run serially for blocks too small to
+    // gain from it.
+    ChannelWorkers channelWorkers;
+    std::atomic<float>* threading = bleh.getRawParameterValue("Threading");
+    bool usingChannelWorkers = false;
+    int requestedWorkers = 0;       // message thread
+
+    // Message thread. Background threads only run between prepareToPlay and releaseResources.
+    bool prepared = false;
+
+    OversamplingStage oversampling;
+    double hostSampleRate = 44100.0;
+    std::atomic<float>* oversamplingFactor = bleh.getRawParameterValue("Oversampling");
+    std::atomic<float>* oversamplingMode = bleh.getRawParameterValue("OversamplingMode");
+
+    LinearPhaseEngine linearPhase{snapshot, bandParams};
+    std::atomic<float>* phaseMode = bleh.getRawParameterValue("PhaseMode");
+    bool usingLinearPhase = false;
+
+    // Takes over from the cascade whenever it has a valid design for the
+    // current rate; the cascade covers anything it can't expand.
+    ParallelFormFilter parallel{snapshot, bandParams};
+    std::atomic<float>* structure = bleh.getRawParameterValue("Structure");
+    bool usingParallel = false;
+
+    // State chunks start with "VNIC" and a format version.
+    static constexpr int stateMagic = 0x43494e56, stateVersion = 1;
+
+    static constexpr double crossfadeSeconds = 0.02;
+    CoefficientHandover handover;
+    CoefficientHandover::Prepared recalled;
+
+    // Bumped before a recall replaces the state. The bands aren't smoothed,
+    // so they hold still until that recall's design arrives and fades in.
+    std::atomic<juce::uint32> recallGeneration { 0 };
+    std::atomic<double> designRate { 44100.0 };
+    int fadeLength = 0, fadeRemaining = 0;
+
+    // Once the input has been below silenceThreshold for longer than the
+    // current design takes to ring out by silenceDecibels, blocks pass
+    // straight through until sound comes back.
+    static constexpr float silenceThreshold = 1.0e-6f;
+    static constexpr double silenceDecibels = 120.0;
+
+    // Poles right on the unit circle (a very high Q, a cut near Nyquist)
+    // can ring for ever on paper; the tail is capped here instead.
+    static constexpr double maxTailSeconds = 30.0;
+    juce::int64 samplesSinceSound = 0, tailSamples = 0;
+    bool idle = false;
+
+    // Stages left at a neutral setting are faded out of the cascade over
+    // this long, and back in the same way when they're moved again.
+    static constexpr double bypassFadeSeconds = 0.01;
+
+    std::atomic<bool> analyzerEnabled { false };
+    AnalyzerFifo preAnalyzer, postAnalyzer;
+
+    void updateChain (const FilterSet& settings, int stages) noexcept;
+    void designStages (CoefficientDesigner& target, const FilterSet& settings, int stages) const noexcept;
+
+    /** The stages that would leave the signal as it is: a 0 dB peak, and cuts parked at the ends of their range. */
+    static int getNeutralStages (const FilterSet& settings) noexcept;
+    void selectOversampling() noexcept;
+    void updateBands() noexcept;
+    void restartChain() noexcept;
+    void selectChannelWorkers() noexcept;
+    void updateChannelWorkers();
+    void updateDesigners();
+    void allocateOversampling();
+    int getLatencyForCurrentSettings() const noexcept;
+    void startCrossfade() noexcept;
+
+    /** Sum of every section's decay time, at the design rate; errs long. */
+    static double getDecaySamples (const CoefficientDesigner& cuts, const FilterSet& settings,
+                                   const BandSet& bandSettings, const BiquadCoefficients* bandSections) noexcept;
+    juce::int64 getTailSamples() const noexcept;
+
+    /** decaySamples at rate in seconds, with anything non-finite or past maxTailSeconds capped. */
+    static double limitTailSeconds (double decaySamples, double rate) noexcept;
+
+    template <typename HostType>
+    bool skipIfIdle (const juce::dsp::AudioBlock<HostType>& block) noexcept;
+
+    template <typename Fn>
+    void forEachChainPair (Fn&& fn)     { fn (singleChains); fn (doubleChains); }
+
+    template <typename HostType>
+    void process (juce::AudioBuffer<HostType>& buffer) noexcept;
+
+    /** Runs fn on the block converted to SampleType, then converts the result back. */
+    template <typename SampleType, typename HostType, typename Fn>
+    void processAs (juce::dsp::AudioBlock<HostType>& block, Fn&& fn) noexcept;
+
+    template <typename SampleType>
+    void processChain (juce::dsp::AudioBlock<SampleType>& block, ChainPair<SampleType>& pair) noexcept;
+
+    template <typename SampleType>
+    void processCrossfade (juce::dsp::AudioBlock<SampleType>& block, ChainPair<SampleType>& pair) noexcept;
+
+    // The oversampling and phase choices aren't automatable, so latency only changes
+    // from the message thread; this just makes sure it is reported from there.
+    void parameterChanged (const juce::String& parameterID, float newValue) override;
+    void handleAsyncUpdate() override;
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (VonicRewriteAudioProcessor)
 };
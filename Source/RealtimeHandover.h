@@ -0,0 +1,69 @@
+/*
+  ==============================================================================
+
+    RealtimeHandover.h
+    Created: 17 Oct 2026 7:18:40am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Single-slot mailbox from a non-realtime thread to the audio thread.
+
+    An atomic state guards one slot. The audio thread only ever does a single
+    compare-exchange and a copy, and skips the fetch if the slot is busy. A
+    writer may wait, but only for the length of that copy. Anything posted
+    but not yet fetched is replaced by the next post.
+*/
+template <typename Payload>
+class RealtimeHandover
+{
+public:
+    /** Any thread but the audio one. fill (Payload&) writes the new contents in place. */
+    template <typename Fill>
+    void post (Fill&& fill)
+    {
+        for (;;)
+        {
+            auto expected = (int) empty;
+
+            if (state.compare_exchange_strong (expected, writing, std::memory_order_acquire))
+                break;
+
+            expected = ready;
+
+            if (state.compare_exchange_strong (expected, writing, std::memory_order_acquire))
+                break;
+
+            juce::Thread::yield();
+        }
+
+        fill (slot);
+        state.store (ready, std::memory_order_release);
+    }
+
+    /** Audio thread. Copies out a posted payload, if there is one. */
+    bool fetch (Payload& dest) noexcept
+    {
+        auto expected = (int) ready;
+
+        if (! state.compare_exchange_strong (expected, reading, std::memory_order_acquire))
+            return false;
+
+        dest = slot;
+        state.store (empty, std::memory_order_release);
+        return true;
+    }
+
+private:
+    enum State { empty, writing, ready, reading };
+
+    std::atomic<int> state { empty };
+    Payload slot;
+};
@@ -0,0 +1,300 @@
+/*
+  ==============================================================================
+
+    RealtimeMonitor.cpp
+    Created: 17 Oct 2026 7:03:10am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#include "RealtimeMonitor.h"
+
+#if VONIC_RT_CHECKS && JUCE_LINUX
+ #include <execinfo.h>
+ #include <dlfcn.h>
+ #include <pthread.h>
+ #include <unistd.h>
+ #include <time.h>
+#endif
+
+namespace
+{
+    // The monitor whose ScopedBlock is live on this thread, if any.
+    thread_local RealtimeMonitor* activeMonitor = nullptr;
+    thread_local bool insideReport = false;
+}
+
+//==============================================================================
+RealtimeMonitor::RealtimeMonitor()
+{
+   #if VONIC_RT_CHECKS
+    startTimerHz (4);
+   #endif
+}
+
+RealtimeMonitor::~RealtimeMonitor()
+{
+    stopTimer();
+}
+
+void RealtimeMonitor::prepare (double newSampleRate, int maximumBlockSize)
+{
+    sampleRate = newSampleRate;
+    lastBudgetMicros = 1.0e6 * maximumBlockSize / newSampleRate;
+    needsReset = true;
+
+   #if VONIC_RT_CHECKS && JUCE_LINUX
+    // The first backtrace() loads libgcc and allocates, so get that out of the way here.
+    void* frames[2];
+    backtrace (frames, 2);
+   #endif
+}
+
+RealtimeMonitor::Stats RealtimeMonitor::getStats() const noexcept
+{
+    Stats stats;
+    stats.numBlocks = numBlocks.load (std::memory_order_relaxed);
+    stats.numOverruns = numOverruns.load (std::memory_order_relaxed);
+    stats.numViolations = numViolations.load (std::memory_order_relaxed);
+    stats.budgetMicros = lastBudgetMicros.load (std::memory_order_relaxed);
+
+    for (size_t kind = 0; kind < violationsOfKind.size(); ++kind)
+        stats.numViolationsOfKind[kind] = violationsOfKind[kind].load (std::memory_order_relaxed);
+
+    if (stats.numBlocks == 0)
+        return stats;
+
+    stats.minMicros = minMicros.load (std::memory_order_relaxed);
+    stats.maxMicros = maxMicros.load (std::memory_order_relaxed);
+    stats.meanMicros = totalMicros.load (std::memory_order_relaxed) / (double) stats.numBlocks;
+
+    // p99 to the resolution of the histogram: the upper edge of the bin that
+    // takes the running count past 99% of the blocks.
+    auto target = (juce::int64) std::ceil (0.99 * (double) stats.numBlocks);
+    juce::int64 count = 0;
+
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        count += histogram[(size_t) bin].load (std::memory_order_relaxed);
+
+        if (count >= target)
+        {
+            stats.p99Micros = juce::jmin (stats.maxMicros, firstBinMicros * std::exp2 ((bin + 1) / (double) binsPerOctave));
+            break;
+        }
+    }
+
+    return stats;
+}
+
+//==============================================================================
+RealtimeMonitor::ScopedBlock::ScopedBlock (RealtimeMonitor& m, int n) noexcept
+    : owner (m), numSamples (n), startTicks (juce::Time::getHighResolutionTicks())
+{
+    owner.applyPendingReset();
+    activeMonitor = &owner;
+}
+
+RealtimeMonitor::ScopedBlock::~ScopedBlock() noexcept
+{
+    activeMonitor = nullptr;
+    owner.record (juce::Time::getHighResolutionTicks() - startTicks, numSamples);
+}
+
+RealtimeMonitor::ScopedAudioThread::ScopedAudioThread (RealtimeMonitor* m) noexcept
+    : previous (activeMonitor)
+{
+    if (m != nullptr)
+        activeMonitor = m;
+}
+
+RealtimeMonitor::ScopedAudioThread::~ScopedAudioThread() noexcept
+{
+    activeMonitor = previous;
+}
+
+// Done as a block starts rather than as it ends, so that block's own
+// violations survive the reset.
+void RealtimeMonitor::applyPendingReset() noexcept
+{
+    if (! needsReset.exchange (false))
+        return;
+
+    numBlocks = 0;
+    numOverruns = 0;
+    numViolations = 0;
+    totalMicros = 0;
+
+    for (auto& count : violationsOfKind)
+        count.store (0, std::memory_order_relaxed);
+
+    for (auto& bin : histogram)
+        bin.store (0, std::memory_order_relaxed);
+}
+
+void RealtimeMonitor::record (juce::int64 ticks, int numSamples) noexcept
+{
+    auto micros = juce::Time::highResolutionTicksToSeconds (ticks) * 1.0e6;
+    auto budget = 1.0e6 * numSamples / sampleRate;
+    auto blocks = numBlocks.load (std::memory_order_relaxed);
+
+    minMicros.store (blocks == 0 ? micros : juce::jmin (micros, minMicros.load (std::memory_order_relaxed)), std::memory_order_relaxed);
+    maxMicros.store (blocks == 0 ? micros : juce::jmax (micros, maxMicros.load (std::memory_order_relaxed)), std::memory_order_relaxed);
+    totalMicros.store (totalMicros.load (std::memory_order_relaxed) + micros, std::memory_order_relaxed);
+    lastBudgetMicros.store (budget, std::memory_order_relaxed);
+
+    if (micros > budget * overrunThreshold.load (std::memory_order_relaxed))
+        numOverruns.fetch_add (1, std::memory_order_relaxed);
+
+    auto bin = micros > firstBinMicros ? (int) (std::log2 (micros / firstBinMicros) * binsPerOctave) : 0;
+    histogram[(size_t) juce::jlimit (0, numBins - 1, bin)].fetch_add (1, std::memory_order_relaxed);
+
+    numBlocks.store (blocks + 1, std::memory_order_relaxed);
+}
+
+//==============================================================================
+void RealtimeMonitor::reportViolation (ViolationKind kind) noexcept
+{
+    auto* monitor = activeMonitor;
+
+    if (monitor == nullptr || insideReport)
+        return;
+
+    insideReport = true;
+    monitor->pushViolation (kind);
+    insideReport = false;
+}
+
+void RealtimeMonitor::pushViolation (ViolationKind kind) noexcept
+{
+    numViolations.fetch_add (1, std::memory_order_relaxed);
+    violationsOfKind[(size_t) kind].fetch_add (1, std::memory_order_relaxed);
+
+    if (writingViolation.test_and_set (std::memory_order_acquire))
+        return; // another thread is writing one; the counters above still tell the story
+
+    {
+        const auto scope = violationFifo.write (1);
+
+        // A full queue drops the backtrace, but the counters still count it.
+        if (scope.blockSize1 > 0)
+        {
+            auto& v = violations[(size_t) scope.startIndex1];
+            v.kind = kind;
+           #if VONIC_RT_CHECKS && JUCE_LINUX
+            v.numFrames = backtrace (v.frames, maxFrames);
+           #else
+            v.numFrames = 0;
+           #endif
+        }
+    }
+
+    writingViolation.clear (std::memory_order_release);
+}
+
+void RealtimeMonitor::timerCallback()
+{
+    const auto scope = violationFifo.read (violationFifo.getNumReady());
+
+    auto logViolation = [] (const Violation& v)
+    {
+        static const char* names[] = { "heap allocation", "lock", "system call" };
+        juce::String message;
+        message << "Vonic: " << names[v.kind] << " on the audio thread";
+
+       #if VONIC_RT_CHECKS && JUCE_LINUX
+        if (auto** symbols = backtrace_symbols (v.frames, v.numFrames))
+        {
+            // Frame 0 is pushViolation and 1 is reportViolation; start from the hook.
+            for (int i = 2; i < v.numFrames; ++i)
+                message << "\n    " << symbols[i];
+
+            ::free (symbols);
+        }
+       #endif
+
+        juce::Logger::writeToLog (message);
+    };
+
+    for (int i = 0; i < scope.blockSize1; ++i)
+        logViolation (violations[(size_t) (scope.startIndex1 + i)]);
+
+    for (int i = 0; i < scope.blockSize2; ++i)
+        logViolation (violations[(size_t) (scope.startIndex2 + i)]);
+}
+
+//==============================================================================
+#if VONIC_RT_CHECKS && JUCE_LINUX
+
+// These replace the libc/libstdc++ symbols for code in this binary. Outside a
+// ScopedBlock they just forward to the real implementation.
+
+template <typename Fn>
+static Fn nextSymbol (const char* name)
+{
+    return reinterpret_cast<Fn> (dlsym (RTLD_NEXT, name));
+}
+
+void* operator new (std::size_t size)
+{
+    RealtimeMonitor::reportViolation (RealtimeMonitor::heapAllocation);
+
+    if (auto* ptr = std::malloc (size == 0 ? 1 : size))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void operator delete (void* ptr) noexcept
+{
+    if (ptr != nullptr)
+        RealtimeMonitor::reportViolation (RealtimeMonitor::heapAllocation);
+
+    std::free (ptr);
+}
+
+void operator delete (void* ptr, std::size_t) noexcept
+{
+    operator delete (ptr);
+}
+
+extern "C"
+{
+    int pthread_mutex_lock (pthread_mutex_t* mutex)
+    {
+        static auto real = nextSymbol<int (*) (pthread_mutex_t*)> ("pthread_mutex_lock");
+        RealtimeMonitor::reportViolation (RealtimeMonitor::lock);
+        return real (mutex);
+    }
+
+    int pthread_cond_wait (pthread_cond_t* cond, pthread_mutex_t* mutex)
+    {
+        static auto real = nextSymbol<int (*) (pthread_cond_t*, pthread_mutex_t*)> ("pthread_cond_wait");
+        RealtimeMonitor::reportViolation (RealtimeMonitor::lock);
+        return real (cond, mutex);
+    }
+
+    ssize_t write (int fd, const void* data, size_t numBytes)
+    {
+        static auto real = nextSymbol<ssize_t (*) (int, const void*, size_t)> ("write");
+        RealtimeMonitor::reportViolation (RealtimeMonitor::systemCall);
+        return real (fd, data, numBytes);
+    }
+
+    ssize_t read (int fd, void* data, size_t numBytes)
+    {
+        static auto real = nextSymbol<ssize_t (*) (int, void*, size_t)> ("read");
+        RealtimeMonitor::reportViolation (RealtimeMonitor::systemCall);
+        return real (fd, data, numBytes);
+    }
+
+    int nanosleep (const struct timespec* duration, struct timespec* remaining)
+    {
+        static auto real = nextSymbol<int (*) (const struct timespec*, struct timespec*)> ("nanosleep");
+        RealtimeMonitor::reportViolation (RealtimeMonitor::systemCall);
+        return real (duration, remaining);
+    }
+}
+
+#endif
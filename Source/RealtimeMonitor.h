@@ -0,0 +1,135 @@
+/*
+  ==============================================================================
+
+    RealtimeMonitor.h
+    Created: 17 Oct 2026 7:03:10am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/** Build with -DVONIC_RT_CHECKS=1 to trap heap, lock and syscall use inside processBlock. */
+#ifndef VONIC_RT_CHECKS
+ #define VONIC_RT_CHECKS 0
+#endif
+
+//==============================================================================
+/**
+    Keeps an eye on the audio thread, and on any helper threads working on
+    its blocks.
+
+    Every block is timed, giving min/mean/max/p99 and a count of blocks that
+    took longer than a chosen fraction of the buffer period. The editor reads
+    these with getStats().
+
+    With VONIC_RT_CHECKS on (Linux only), operator new/delete, pthread mutex
+    and condition waits, and read/write/nanosleep are hooked. Any of those
+    that run inside a ScopedBlock or ScopedAudioThread record a backtrace into a lock-free queue,
+    and a timer on the message thread symbolises and logs them.
+*/
+class RealtimeMonitor  : private juce::Timer
+{
+public:
+    enum ViolationKind
+    {
+        heapAllocation,
+        lock,
+        systemCall,
+        numViolationKinds
+    };
+
+    struct Stats
+    {
+        juce::int64 numBlocks = 0, numOverruns = 0, numViolations = 0;
+        std::array<juce::int64, numViolationKinds> numViolationsOfKind {};
+        double minMicros = 0, meanMicros = 0, maxMicros = 0, p99Micros = 0;
+        double budgetMicros = 0;
+    };
+
+    RealtimeMonitor();
+    ~RealtimeMonitor() override;
+
+    void prepare (double sampleRate, int maximumBlockSize);
+
+    /** Blocks longer than this fraction of their own duration count as overruns. */
+    void setOverrunThreshold (float fractionOfBufferPeriod) noexcept   { overrunThreshold = fractionOfBufferPeriod; }
+    float getOverrunThreshold() const noexcept                          { return overrunThreshold; }
+
+    /** Any thread. */
+    Stats getStats() const noexcept;
+    void resetStats() noexcept                                          { needsReset = true; }
+
+    //==============================================================================
+    /** Wrap processBlock in one of these. */
+    class ScopedBlock
+    {
+    public:
+        ScopedBlock (RealtimeMonitor&, int numSamples) noexcept;
+        ~ScopedBlock() noexcept;
+
+    private:
+        RealtimeMonitor& owner;
+        int numSamples;
+        juce::int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedBlock)
+    };
+
+    /** Makes another thread audio-critical while it runs part of a block, e.g.
+        a channel worker. Its violations are reported like the audio thread's,
+        but it records no timing. A null monitor does nothing.
+    */
+    class ScopedAudioThread
+    {
+    public:
+        explicit ScopedAudioThread (RealtimeMonitor*) noexcept;
+        ~ScopedAudioThread() noexcept;
+
+    private:
+        RealtimeMonitor* previous;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedAudioThread)
+    };
+
+    /** Called by the hooks; does nothing outside a ScopedBlock or ScopedAudioThread. */
+    static void reportViolation (ViolationKind kind) noexcept;
+
+private:
+    static constexpr int numBins = 80, binsPerOctave = 4;
+    static constexpr double firstBinMicros = 0.25;
+    static constexpr int maxFrames = 24, maxPendingViolations = 32;
+
+    struct Violation
+    {
+        ViolationKind kind;
+        int numFrames;
+        void* frames[maxFrames];
+    };
+
+    void applyPendingReset() noexcept;
+    void record (juce::int64 ticks, int numSamples) noexcept;
+    void pushViolation (ViolationKind kind) noexcept;
+    void timerCallback() override;
+
+    double sampleRate = 44100.0;
+    std::atomic<float> overrunThreshold { 0.5f };
+    std::atomic<bool> needsReset { false };
+
+    // Written by the audio thread only (the violation counts also by its
+    // helper threads), read from anywhere.
+    std::atomic<juce::int64> numBlocks { 0 }, numOverruns { 0 }, numViolations { 0 };
+    std::array<std::atomic<juce::int64>, numViolationKinds> violationsOfKind {};
+    std::atomic<double> totalMicros { 0 }, minMicros { 0 }, maxMicros { 0 }, lastBudgetMicros { 0 };
+    std::array<std::atomic<juce::int64>, numBins> histogram {};
+
+    // The fifo takes one writer at a time; a thread that finds it busy only counts its violation.
+    std::atomic_flag writingViolation = ATOMIC_FLAG_INIT;
+    juce::AbstractFifo violationFifo { maxPendingViolations };
+    std::array<Violation, maxPendingViolations> violations;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RealtimeMonitor)
+};
@@ -0,0 +1,232 @@
+/*
+  ==============================================================================
+
+    ResponseCurve.cpp
+    Created: 17 Oct 2026 7:10:32am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#include "ResponseCurve.h"
+#include "SpectrumAnalyzer.h"
+
+ResponseCurve::ResponseCurve (VonicRewriteAudioProcessor& p)
+    : processor (p), curve (p.bleh, {}), sideCurve (p.bleh, "Side"),
+      stereoMode (p.bleh.getRawParameterValue ("StereoMode")), bandParams (p.bleh)
+{
+    setInterceptsMouseClicks (false, false);
+    startTimerHz (60);
+}
+
+//==============================================================================
+void ResponseCurve::timerCallback()
+{
+    // The curve is designed where the filters are, above the host rate when oversampling.
+    auto rate = processor.getDesignRate();
+    auto latestBands = bandParams.read();
+    auto midSide = stereoMode->load() > 0.5f;
+    auto force = false;
+
+    if (rate != sampleRate)
+    {
+        sampleRate = rate;
+        rebuildGrid();
+        force = true;
+    }
+
+    if (numPoints == 0)
+        return;
+
+    auto changed = force || midSide != showSide;
+
+    if (force || latestBands != bandSettings)
+    {
+        bandSettings = latestBands;
+        evaluateBands();
+        changed = true;
+    }
+
+    changed = updateCurve (curve, force) || changed;
+
+    // The side set isn't followed while it's hidden, so catch up in full when it appears.
+    if (midSide)
+        changed = updateCurve (sideCurve, force || ! showSide) || changed;
+
+    showSide = midSide;
+
+    if (! changed)
+        return;
+
+    rebuildPath (curve);
+
+    if (showSide)
+        rebuildPath (sideCurve);
+
+    repaint();
+}
+
+bool ResponseCurve::updateCurve (Curve& c, bool force)
+{
+    auto latest = c.parameters.load();
+    auto stages = force ? (int) allStages : latest.getChangedStages (c.settings);
+
+    if (stages == 0)
+        return false;
+
+    c.settings = latest;
+    c.designer.update (c.settings, stages);
+
+    for (int stage = 0; stage < numCutStages; ++stage)
+        if (stages & (1 << stage))
+            evaluateStage (c, (Stage) stage);
+
+    return true;
+}
+
+void ResponseCurve::rebuildGrid()
+{
+    numPoints = getWidth();
+
+    auto numRegisters = (size_t) (numPoints + (int) Register::size() - 1) / Register::size();
+    cos1.assign (numRegisters, Register::expand (0.f));
+    cos2.assign (numRegisters, Register::expand (0.f));
+    power.assign (numRegisters, Register::expand (1.f));
+    numerators.resize (numRegisters);
+    denominators.resize (numRegisters);
+
+    auto* c1 = reinterpret_cast<float*> (cos1.data());
+    auto* c2 = reinterpret_cast<float*> (cos2.data());
+
+    for (int x = 0; x < numPoints; ++x)
+    {
+        auto frequency = SpectrumAnalyzer::minFrequency
+                       * std::pow (SpectrumAnalyzer::maxFrequency / SpectrumAnalyzer::minFrequency, (double) x / numPoints);
+        auto omega = juce::MathConstants<double>::twoPi * juce::jmin (frequency, sampleRate * 0.5) / sampleRate;
+        c1[x] = (float) std::cos (omega);
+        c2[x] = (float) std::cos (2.0 * omega);
+    }
+
+    for (auto* c : { &curve, &sideCurve })
+    {
+        c->designer.prepare (sampleRate);
+
+        for (auto& decibels : c->stageDecibels)
+            decibels.assign ((size_t) numPoints, 0.f);
+    }
+
+    bandDecibels.assign ((size_t) numPoints, 0.f);
+}
+
+void ResponseCurve::accumulatePower (const BiquadCoefficients* sections, int numSections) noexcept
+{
+    for (int i = 0; i < numSections; ++i)
+    {
+        // |B(e^jw)|^2 = b0^2 + b1^2 + b2^2 + 2 (b0 b1 + b1 b2) cos w + 2 b0 b2 cos 2w, same for A with a0 = 1.
+        auto& c = sections[i];
+        auto n0 = Register::expand ((float) (c.b0 * c.b0 + c.b1 * c.b1 + c.b2 * c.b2));
+        auto n1 = Register::expand ((float) (2.0 * (c.b0 * c.b1 + c.b1 * c.b2)));
+        auto n2 = Register::expand ((float) (2.0 * c.b0 * c.b2));
+        auto d0 = Register::expand ((float) (1.0 + c.a1 * c.a1 + c.a2 * c.a2));
+        auto d1 = Register::expand ((float) (2.0 * (c.a1 + c.a1 * c.a2)));
+        auto d2 = Register::expand ((float) (2.0 * c.a2));
+
+        for (size_t r = 0; r < power.size(); ++r)
+        {
+            numerators[r] = n0 + n1 * cos1[r] + n2 * cos2[r];
+            denominators[r] = d0 + d1 * cos1[r] + d2 * cos2[r];
+        }
+
+        // SIMDRegister has no divide, so finish on the flat view; the compiler
+        // vectorises this loop.
+        auto* num = reinterpret_cast<const float*> (numerators.data());
+        auto* den = reinterpret_cast<const float*> (denominators.data());
+        auto* out = reinterpret_cast<float*> (power.data());
+
+        for (size_t j = 0; j < power.size() * Register::size(); ++j)
+            out[j] *= num[j] / juce::jmax (den[j], 1.0e-30f);
+    }
+}
+
+void ResponseCurve::evaluateStage (Curve& c, Stage stage)
+{
+    std::fill (power.begin(), power.end(), Register::expand (1.f));
+
+    if (stage == lowCut)
+        accumulatePower (c.designer.getLowCut().data(), CoefficientDesigner::getNumSections (c.settings.lowCutSlope));
+    else if (stage == peak)
+        accumulatePower (&c.designer.getPeak(), 1);
+    else
+        accumulatePower (c.designer.getHighCut().data(), CoefficientDesigner::getNumSections (c.settings.highCutSlope));
+
+    storeDecibels (c.stageDecibels[(size_t) stage]);
+}
+
+void ResponseCurve::evaluateBands()
+{
+    std::fill (power.begin(), power.end(), Register::expand (1.f));
+
+    for (auto& band : bandSettings)
+    {
+        if (band.isActive())
+        {
+            BiquadCoefficients coefficients;
+            CoefficientDesigner::designBand (coefficients, sampleRate, band);
+            accumulatePower (&coefficients, 1);
+        }
+    }
+
+    storeDecibels (bandDecibels);
+}
+
+void ResponseCurve::storeDecibels (std::vector<float>& decibels) const
+{
+    auto* values = reinterpret_cast<const float*> (power.data());
+
+    for (int x = 0; x < numPoints; ++x)
+        decibels[(size_t) x] = 10.f * std::log10 (juce::jmax (values[x], 1.0e-12f));
+}
+
+void ResponseCurve::rebuildPath (Curve& c)
+{
+    c.path.clear();
+
+    auto height = (float) getHeight();
+
+    for (int x = 0; x < numPoints; ++x)
+    {
+        auto decibels = bandDecibels[(size_t) x];
+
+        for (auto& stage : c.stageDecibels)
+            decibels += stage[(size_t) x];
+
+        auto y = juce::jmap (juce::jlimit (-rangeDecibels, rangeDecibels, decibels), -rangeDecibels, rangeDecibels, height, 0.f);
+
+        if (x == 0)
+            c.path.startNewSubPath (0.f, y);
+        else
+            c.path.lineTo ((float) x, y);
+    }
+}
+
+//==============================================================================
+void ResponseCurve::paint (juce::Graphics& g)
+{
+    g.setColour (juce::Colours::white.withAlpha (0.2f));
+    g.drawHorizontalLine (getHeight() / 2, 0.f, (float) getWidth());
+
+    if (showSide)
+    {
+        g.setColour (juce::Colours::orange);
+        g.strokePath (sideCurve.path, juce::PathStrokeType (2.f));
+    }
+
+    g.setColour (juce::Colours::white);
+    g.strokePath (curve.path, juce::PathStrokeType (2.f));
+}
+
+void ResponseCurve::resized()
+{
+    // Force a full rebuild at the new width on the next tick.
+    sampleRate = 0.0;
+}
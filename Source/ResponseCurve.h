@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    ResponseCurve.h
+    Created: 17 Oct 2026 7:10:32am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+//==============================================================================
+/**
+    Draws the combined magnitude response of the low cut, peak, high cut and
+    parametric band stages, on the same log frequency axis as the SpectrumAnalyzer.
+    While the EQ runs in mid/side a second curve, from the Side* parameters,
+    is drawn for the side channel; the bands apply to both.
+
+    The curve has one point per pixel column. cos(w) and cos(2w) for those
+    points are computed once per size or sample rate, packed into SIMD
+    registers, so a section's |H|^2 across the whole width is a few
+    multiply-adds and one divide per register. Each stage's dB curve is
+    cached, and when a knob moves only that stage is evaluated again before
+    the stages are summed into the cached path.
+*/
+class ResponseCurve  : public juce::Component,
+                       private juce::Timer
+{
+public:
+    explicit ResponseCurve (VonicRewriteAudioProcessor&);
+
+    void paint (juce::Graphics&) override;
+    void resized() override;
+
+    static constexpr float rangeDecibels = 24.f;
+
+private:
+    using Register = juce::dsp::SIMDRegister<float>;
+
+    enum Stage { lowCut, peak, highCut, numCutStages };
+
+    /** The cut and peak stages of one filter set, with the path they sum to. */
+    struct Curve
+    {
+        Curve (juce::AudioProcessorValueTreeState& state, const juce::String& prefix) : parameters (state, prefix) {}
+
+        ParameterSnapshot parameters;
+        CoefficientDesigner designer;
+        FilterSet settings;
+        std::array<std::vector<float>, numCutStages> stageDecibels;
+        juce::Path path;
+    };
+
+    void timerCallback() override;
+    void rebuildGrid();
+
+    /** Redesigns whatever moved in the curve's set, or all of it if forced. Returns false if nothing did. */
+    bool updateCurve (Curve& curve, bool force);
+    void evaluateStage (Curve& curve, Stage stage);
+    void evaluateBands();
+    void rebuildPath (Curve& curve);
+
+    /** Multiplies |H|^2 of each section into power, across the whole grid. */
+    void accumulatePower (const BiquadCoefficients* sections, int numSections) noexcept;
+    void storeDecibels (std::vector<float>& decibels) const;
+
+    VonicRewriteAudioProcessor& processor;
+    Curve curve, sideCurve;
+    std::atomic<float>* stereoMode;
+    bool showSide = false;
+    BandSet bandSettings;
+    BandParameters bandParams;
+    double sampleRate = 0.0;
+
+    int numPoints = 0;
+    std::vector<Register> cos1, cos2, power, numerators, denominators;
+    std::vector<float> bandDecibels;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ResponseCurve)
+};
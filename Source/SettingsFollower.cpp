@@ -0,0 +1,56 @@
+/*
+  ==============================================================================
+
+    SettingsFollower.cpp
+    Created: 17 Oct 2026 7:52:04am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#include "SettingsFollower.h"
+
+SettingsFollower::SettingsFollower (const juce::String& threadName, const ParameterSnapshot& s,
+                                    const BandParameters& b, int pollMs, Rebuild r)
+    : juce::Thread (threadName), snapshot (s), bandParams (b), pollMilliseconds (pollMs), rebuild (std::move (r))
+{
+}
+
+SettingsFollower::~SettingsFollower()
+{
+    stop();
+}
+
+void SettingsFollower::start (const FilterSet& initial)
+{
+    stop();
+
+    // Taken before the rebuild, so a change that lands during it is caught up with.
+    seen = snapshot.getGeneration();
+    seenBands = bandParams.read();
+    seenRate = designRate.load (std::memory_order_relaxed);
+
+    rebuild (initial, seenBands, seenRate);
+    startThread();
+}
+
+void SettingsFollower::run()
+{
+    while (! threadShouldExit())
+    {
+        wait (pollMilliseconds);
+
+        auto rate = designRate.load (std::memory_order_relaxed);
+        juce::uint32 generation;
+        auto settings = snapshot.read (&generation);
+        auto bandSettings = bandParams.read();
+
+        if (generation != seen || bandSettings != seenBands || rate != seenRate)
+        {
+            rebuild (settings, bandSettings, rate);
+            seen = generation;
+            seenBands = bandSettings;
+            seenRate = rate;
+        }
+    }
+}
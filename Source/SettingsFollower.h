@@ -0,0 +1,65 @@
+/*
+  ==============================================================================
+
+    SettingsFollower.h
+    Created: 17 Oct 2026 7:52:04am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ParameterSnapshot.h"
+#include "BandParameters.h"
+
+//==============================================================================
+/**
+    Background thread for the engines that design off the audio thread
+    (linear phase, parallel form).
+
+    start() runs rebuild once on the calling thread, so the engine has a
+    design straight away. From then on the thread reads the ParameterSnapshot,
+    the band parameters and the design rate every pollMilliseconds, and calls
+    rebuild whenever one of them has moved. It polls because parameter
+    changes land on the audio thread, which can't signal it.
+
+    The engines only start it while their mode is selected, so an instance
+    that uses neither has no thread at all.
+*/
+class SettingsFollower  : private juce::Thread
+{
+public:
+    using Rebuild = std::function<void (const FilterSet&, const BandSet&, double designRate)>;
+
+    SettingsFollower (const juce::String& threadName, const ParameterSnapshot& snapshot,
+                      const BandParameters& bands, int pollMilliseconds, Rebuild rebuild);
+    ~SettingsFollower() override;
+
+    /** Message thread. Rebuilds from initial, then follows the settings until stop(). */
+    void start (const FilterSet& initial);
+    void stop()                                     { stopThread (2000); }
+
+    bool isRunning() const noexcept                 { return isThreadRunning(); }
+
+    /** Any thread. */
+    void setDesignRate (double newRate) noexcept    { designRate.store (newRate, std::memory_order_relaxed); }
+
+private:
+    void run() override;
+
+    const ParameterSnapshot& snapshot;
+    const BandParameters& bandParams;
+    const int pollMilliseconds;
+    const Rebuild rebuild;
+
+    std::atomic<double> designRate { 44100.0 };
+
+    // What the last rebuild saw; the thread's own once it is running.
+    juce::uint32 seen = 0;
+    BandSet seenBands;
+    double seenRate = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SettingsFollower)
+};
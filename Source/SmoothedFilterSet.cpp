@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    SmoothedFilterSet.cpp
+    Created: 17 Oct 2026 7:04:51am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#include "SmoothedFilterSet.h"
+
+void SmoothedFilterSet::prepare (double sampleRate, const FilterSet& initial) noexcept
+{
+    lowCutFreq.reset (sampleRate, rampSeconds);
+    highCutFreq.reset (sampleRate, rampSeconds);
+    peakFreq.reset (sampleRate, rampSeconds);
+    peakQual.reset (sampleRate, rampSeconds);
+    peakGain.reset (sampleRate, rampSeconds);
+
+    lowCutFreq.setCurrentAndTargetValue (initial.lowCutFreq);
+    highCutFreq.setCurrentAndTargetValue (initial.highCutFreq);
+    peakFreq.setCurrentAndTargetValue (initial.peakFreq);
+    peakQual.setCurrentAndTargetValue (initial.peakQual);
+    peakGain.setCurrentAndTargetValue (initial.peakGain);
+
+    current = initial;
+}
+
+void SmoothedFilterSet::setTarget (const FilterSet& target, int stages) noexcept
+{
+    if (stages & lowCutStage)
+    {
+        lowCutFreq.setTargetValue (target.lowCutFreq);
+        current.lowCutSlope = target.lowCutSlope;
+    }
+
+    if (stages & peakStage)
+    {
+        peakFreq.setTargetValue (target.peakFreq);
+        peakQual.setTargetValue (target.peakQual);
+        peakGain.setTargetValue (target.peakGain);
+    }
+
+    if (stages & highCutStage)
+    {
+        highCutFreq.setTargetValue (target.highCutFreq);
+        current.highCutSlope = target.highCutSlope;
+    }
+}
+
+bool SmoothedFilterSet::isSmoothing() const noexcept
+{
+    return lowCutFreq.isSmoothing() || highCutFreq.isSmoothing()
+        || peakFreq.isSmoothing() || peakQual.isSmoothing() || peakGain.isSmoothing();
+}
+
+int SmoothedFilterSet::advance (int numSamples) noexcept
+{
+    int moved = 0;
+
+    if (lowCutFreq.isSmoothing())
+    {
+        current.lowCutFreq = lowCutFreq.skip (numSamples);
+        moved |= lowCutStage;
+    }
+
+    if (peakFreq.isSmoothing() || peakQual.isSmoothing() || peakGain.isSmoothing())
+    {
+        current.peakFreq = peakFreq.skip (numSamples);
+        current.peakQual = peakQual.skip (numSamples);
+        current.peakGain = peakGain.skip (numSamples);
+        moved |= peakStage;
+    }
+
+    if (highCutFreq.isSmoothing())
+    {
+        current.highCutFreq = highCutFreq.skip (numSamples);
+        moved |= highCutStage;
+    }
+
+    return moved;
+}
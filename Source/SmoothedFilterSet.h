@@ -0,0 +1,49 @@
+/*
+  ==============================================================================
+
+    SmoothedFilterSet.h
+    Created: 17 Oct 2026 7:04:51am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FilterSet.h"
+
+//==============================================================================
+/**
+    Ramps a FilterSet towards the latest parameter values.
+
+    Frequencies and Q glide multiplicatively, the peak gain linearly in dB.
+    The slopes can't be interpolated, so they switch straight away. Only the
+    processor's control-rate loop calls advance(), so the ramp costs nothing
+    once everything has arrived.
+*/
+class SmoothedFilterSet
+{
+public:
+    static constexpr double rampSeconds = 0.05;
+
+    /** Jumps straight to initial, with no ramp. */
+    void prepare (double sampleRate, const FilterSet& initial) noexcept;
+
+    /** Starts ramping the stages flagged in the FilterStages mask towards target. */
+    void setTarget (const FilterSet& target, int stages) noexcept;
+
+    bool isSmoothing() const noexcept;
+
+    /** Moves numSamples along the ramp, and returns a FilterStages mask of what moved. */
+    int advance (int numSamples) noexcept;
+
+    const FilterSet& getCurrent() const noexcept    { return current; }
+
+private:
+    using Multiplicative = juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative>;
+
+    Multiplicative lowCutFreq, highCutFreq, peakFreq, peakQual;
+    juce::SmoothedValue<float> peakGain;
+    FilterSet current;
+};
@@ -0,0 +1,171 @@
+/*
+  ==============================================================================
+
+    SpectrumAnalyzer.cpp
+    Created: 17 Oct 2026 7:09:26am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#include "SpectrumAnalyzer.h"
+
+namespace
+{
+    constexpr float averaging = 0.8f;           // weight of the previous frame's power
+    constexpr float peakDecayPerFrame = 0.25f;  // dB
+}
+
+SpectrumAnalyzer::SpectrumAnalyzer (VonicRewriteAudioProcessor& p)
+    : processor (p), pre (p.getAnalyzerFifo (false)), post (p.getAnalyzerFifo (true))
+{
+    juce::dsp::WindowingFunction<float>::fillWindowingTables (window.data(), (size_t) fftSize,
+                                                              juce::dsp::WindowingFunction<float>::hann, false);
+    setOpaque (true);
+    processor.setAnalyzerEnabled (true);
+    startTimerHz (30);
+}
+
+SpectrumAnalyzer::~SpectrumAnalyzer()
+{
+    processor.setAnalyzerEnabled (false);
+}
+
+//==============================================================================
+void SpectrumAnalyzer::timerCallback()
+{
+    auto rate = processor.getSampleRate();
+
+    if (rate <= 0.0)
+        return;
+
+    if (rate != binsForRate)
+    {
+        binsForRate = rate;
+        resized();
+    }
+
+    analyse (pre);
+    analyse (post);
+    updatePaths (pre);
+    updatePaths (post);
+    repaint();
+}
+
+void SpectrumAnalyzer::analyse (Trace& trace)
+{
+    trace.numPending += trace.fifo.pull (trace.pending.data() + trace.numPending,
+                                         (int) trace.pending.size() - trace.numPending);
+
+    // Hann at 75% overlap. The gain scales a full-scale sine to 0 dB.
+    const auto scale = 4.f / (float) fftSize;
+    auto consumed = 0;
+
+    for (; trace.numPending - consumed >= hopSize; consumed += hopSize)
+    {
+        std::move (trace.frame.begin() + hopSize, trace.frame.end(), trace.frame.begin());
+        std::copy_n (trace.pending.begin() + consumed, hopSize, trace.frame.end() - hopSize);
+
+        juce::FloatVectorOperations::multiply (fftData.data(), trace.frame.data(), window.data(), fftSize);
+        fft.performFrequencyOnlyForwardTransform (fftData.data(), true);
+
+        for (size_t bin = 0; bin < (size_t) numBins; ++bin)
+        {
+            auto magnitude = fftData[bin] * scale;
+            trace.power[bin] = averaging * trace.power[bin] + (1.f - averaging) * magnitude * magnitude;
+        }
+    }
+
+    std::move (trace.pending.begin() + consumed, trace.pending.begin() + trace.numPending, trace.pending.begin());
+    trace.numPending -= consumed;
+
+    for (size_t bin = 0; bin < (size_t) numBins; ++bin)
+    {
+        auto decibels = juce::Decibels::gainToDecibels (trace.power[bin], -200.f) * 0.5f;
+        trace.peak[bin] = juce::jmax (decibels, trace.peak[bin] - peakDecayPerFrame);
+    }
+}
+
+float SpectrumAnalyzer::binToY (const std::vector<float>& decibels, int column) const noexcept
+{
+    auto [first, last] = columnBins[(size_t) column];
+    auto level = *std::max_element (decibels.begin() + first, decibels.begin() + last + 1);
+
+    return juce::jmap (juce::jlimit (minDecibels, maxDecibels, level),
+                       minDecibels, maxDecibels, (float) getHeight(), 0.f);
+}
+
+void SpectrumAnalyzer::updatePaths (Trace& trace)
+{
+    trace.averagePath.clear();
+    trace.peakPath.clear();
+
+    if (columnBins.empty())
+        return;
+
+    for (size_t bin = 0; bin < (size_t) numBins; ++bin)
+        scratch[bin] = juce::Decibels::gainToDecibels (trace.power[bin], -200.f) * 0.5f;
+
+    trace.averagePath.startNewSubPath (0.f, binToY (scratch, 0));
+    trace.peakPath.startNewSubPath (0.f, binToY (trace.peak, 0));
+
+    for (int x = 1; x < (int) columnBins.size(); ++x)
+    {
+        trace.averagePath.lineTo ((float) x, binToY (scratch, x));
+        trace.peakPath.lineTo ((float) x, binToY (trace.peak, x));
+    }
+}
+
+//==============================================================================
+void SpectrumAnalyzer::paint (juce::Graphics& g)
+{
+    g.fillAll (juce::Colours::black);
+
+    g.setColour (juce::Colours::white.withAlpha (0.1f));
+
+    for (auto frequency : { 50.f, 100.f, 200.f, 500.f, 1000.f, 2000.f, 5000.f, 10000.f })
+    {
+        auto x = (float) getWidth() * std::log (frequency / minFrequency) / std::log (maxFrequency / minFrequency);
+        g.drawVerticalLine (juce::roundToInt (x), 0.f, (float) getHeight());
+    }
+
+    for (auto decibels = -84.f; decibels < maxDecibels; decibels += 12.f)
+        g.drawHorizontalLine (juce::roundToInt (juce::jmap (decibels, minDecibels, maxDecibels, (float) getHeight(), 0.f)),
+                              0.f, (float) getWidth());
+
+    g.setColour (juce::Colours::grey.withAlpha (0.6f));
+    g.strokePath (pre.averagePath, juce::PathStrokeType (1.f));
+
+    g.setColour (juce::Colours::orange.withAlpha (0.5f));
+    g.strokePath (post.peakPath, juce::PathStrokeType (1.f));
+
+    g.setColour (juce::Colours::orange);
+    g.strokePath (post.averagePath, juce::PathStrokeType (1.5f));
+}
+
+void SpectrumAnalyzer::resized()
+{
+    columnBins.clear();
+
+    auto width = getWidth();
+
+    if (width <= 0 || binsForRate <= 0.0)
+        return;
+
+    // Each column takes the loudest bin in its frequency span; at the low end,
+    // where one bin is wider than a column, that is just the nearest bin.
+    auto binWidth = binsForRate / fftSize;
+    auto toBin = [=] (double x)
+    {
+        auto frequency = minFrequency * std::pow (maxFrequency / minFrequency, x / width);
+        return juce::jlimit (0, numBins - 1, (int) std::round (frequency / binWidth));
+    };
+
+    columnBins.reserve ((size_t) width);
+
+    for (int x = 0; x < width; ++x)
+    {
+        auto first = toBin (x);
+        columnBins.emplace_back (first, juce::jmax (first, toBin (x + 1) - 1));
+    }
+}
@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    SpectrumAnalyzer.h
+    Created: 17 Oct 2026 7:09:26am
+    Author:  vortex
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+//==============================================================================
+/**
+    Pre/post EQ spectrum, drawn on a log frequency axis.
+
+    The processor only feeds its AnalyzerFifos while one of these exists. The
+    windowed FFTs, power averaging and peak hold all run in the timer callback
+    on the message thread, and the curves are reduced to one point per pixel
+    column before a Path is built.
+*/
+class SpectrumAnalyzer  : public juce::Component,
+                          private juce::Timer
+{
+public:
+    explicit SpectrumAnalyzer (VonicRewriteAudioProcessor&);
+    ~SpectrumAnalyzer() override;
+
+    void paint (juce::Graphics&) override;
+    void resized() override;
+
+    static constexpr float minFrequency = 20.f, maxFrequency = 20000.f;
+    static constexpr float minDecibels = -90.f, maxDecibels = 6.f;
+
+private:
+    static constexpr int fftOrder = 12, fftSize = 1 << fftOrder, hopSize = fftSize / 4;
+    static constexpr int numBins = fftSize / 2 + 1;
+
+    struct Trace
+    {
+        explicit Trace (AnalyzerFifo& f) : fifo (f) {}
+
+        AnalyzerFifo& fifo;
+        std::vector<float> pending = std::vector<float> ((size_t) AnalyzerFifo::capacity);
+        std::vector<float> frame = std::vector<float> ((size_t) fftSize);
+        int numPending = 0;
+
+        std::vector<float> power = std::vector<float> ((size_t) numBins);     // averaged, linear
+        std::vector<float> peak = std::vector<float> ((size_t) numBins, minDecibels);
+        juce::Path averagePath, peakPath;
+    };
+
+    void timerCallback() override;
+    void analyse (Trace& trace);
+    void updatePaths (Trace& trace);
+    float binToY (const std::vector<float>& decibels, int column) const noexcept;
+
+    VonicRewriteAudioProcessor& processor;
+    juce::dsp::FFT fft { fftOrder };
+    std::vector<float> window = std::vector<float> ((size_t) fftSize);
+    std::vector<float> fftData = std::vector<float> ((size_t) fftSize * 2);
+    std::vector<float> scratch = std::vector<float> ((size_t) numBins);
+
+    Trace pre, post;
+
+    // Per pixel column: the FFT bin range it covers, refreshed in resized().
+    std::vector<std::pair<int, int>> columnBins;
+    double binsForRate = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectrumAnalyzer)
+};
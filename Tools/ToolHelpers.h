@@ -0,0 +1,101 @@
+/*
+  ==============================================================================
+
+    ToolHelpers.h
+    Created: 17 Oct 2026 7:00:33am
+    Author:  vortex
+
+    Bits shared by the command-line tools that drive the processor without a host.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace VonicTools
+{
+    /** Looks up the parameter in "ParameterID=value". Returns nullptr if there
+        is no such parameter or no value.
+    */
+    inline juce::RangedAudioParameter* findParameter (juce::AudioProcessorValueTreeState& state,
+                                                      const juce::String& assignment, juce::String& value)
+    {
+        auto id = assignment.upToFirstOccurrenceOf ("=", false, false).trim();
+        value = assignment.fromFirstOccurrenceOf ("=", false, false).trim();
+        auto* param = state.getParameter (id);
+
+        return value.isNotEmpty() ? param : nullptr;
+    }
+
+    /** Applies "ParameterID=value", where value is in the parameter's own units
+        (Hz, dB, or the choice index for the slopes).
+    */
+    inline bool setParameter (juce::AudioProcessorValueTreeState& state, const juce::String& assignment)
+    {
+        juce::String value;
+        auto* param = findParameter (state, assignment, value);
+
+        if (param == nullptr)
+            return false;
+
+        param->setValueNotifyingHost (param->convertTo0to1 (value.getFloatValue()));
+        return true;
+    }
+
+    /** Reads a preset made of "ParameterID=value" lines. Blank lines and lines
+        starting with '#' are skipped.
+    */
+    inline bool readPreset (const juce::File& file, juce::StringArray& assignments, juce::String& error)
+    {
+        if (! file.existsAsFile())
+        {
+            error = "Preset not found: " + file.getFullPathName();
+            return false;
+        }
+
+        juce::StringArray lines;
+        file.readLines (lines);
+
+        for (auto& line : lines)
+        {
+            auto trimmed = line.trim();
+
+            if (trimmed.isNotEmpty() && ! trimmed.startsWithChar ('#'))
+                assignments.add (trimmed);
+        }
+
+        return true;
+    }
+
+    inline bool loadPreset (juce::AudioProcessorValueTreeState& state, const juce::File& file, juce::String& error)
+    {
+        juce::StringArray assignments;
+
+        if (! readPreset (file, assignments, error))
+            return false;
+
+        for (auto& assignment : assignments)
+        {
+            if (! setParameter (state, assignment))
+            {
+                error = "Bad preset line in " + file.getFileName() + ": " + assignment;
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /** Sets the processor's main buses to numChannels in and out. */
+    inline bool setMainBusChannels (juce::AudioProcessor& processor, int numChannels)
+    {
+        auto layout = processor.getBusesLayout();
+        auto channelSet = juce::AudioChannelSet::canonicalChannelSet (numChannels);
+
+        layout.inputBuses.getReference (0) = channelSet;
+        layout.outputBuses.getReference (0) = channelSet;
+        return processor.setBusesLayout (layout);
+    }
+}
@@ -0,0 +1,379 @@
+/*
+  ==============================================================================
+
+    VonicBench.cpp
+    Created: 17 Oct 2026 7:01:27am
+    Author:  vortex
+
+    Times processBlock over a sweep of block sizes, sample rates, slopes,
+    channel counts and static vs. automated parameters, and prints the
+    results as JSON so runs can be diffed.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../Source/PluginProcessor.h"
+#include "ToolHelpers.h"
+
+//==============================================================================
+namespace
+{
+    struct BenchConfig
+    {
+        int blockSize;
+        double sampleRate;
+        int slope;
+        int numChannels;
+        bool automated;
+    };
+
+    struct BenchOptions
+    {
+        juce::Array<int> blockSizes { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+        juce::Array<double> sampleRates { 44100.0, 48000.0, 96000.0, 192000.0, 384000.0 };
+        juce::Array<int> slopes { 0, 1, 2, 3 };
+        juce::Array<int> channelCounts { 1, 2, 6, 12 };
+        double secondsPerRun = 1.0;
+        int numBands = 0;
+        bool parallel = false, doublePrecision = false, svf = false;
+        juce::File output;
+    };
+
+    double ticksToNanoseconds (juce::int64 ticks)
+    {
+        return juce::Time::highResolutionTicksToSeconds (ticks) * 1.0e9;
+    }
+
+    void printUsage()
+    {
+        std::cout << "Usage: VonicBench [options]\n"
+                     "\n"
+                     "  --blocks <list>      block sizes, e.g. 32,256,1024\n"
+                     "  --rates <list>       sample rates, e.g. 48000,96000\n"
+                     "  --slopes <list>      cut slopes as choice indices 0-3\n"
+                     "  --channels <list>    channel counts\n"
+                     "  --seconds <s>        audio rendered per run (default 1)\n"
+                     "  --bands <n>          parametric bands switched on, 0-16 (default 0)\n"
+                     "  --parallel           run the EQ as parallel sections instead of a cascade\n"
+                     "  --double             run the cascade in double precision\n"
+                     "  --svf                run the cascade as state-variable sections\n"
+                     "  --quick              small sweep for a fast sanity check\n"
+                     "  --out <file>         write JSON here instead of stdout\n";
+    }
+
+    template <typename Type>
+    juce::Array<Type> parseList (const juce::String& text)
+    {
+        juce::Array<Type> values;
+
+        for (auto& token : juce::StringArray::fromTokens (text, ",", {}))
+            values.add (static_cast<Type> (token.getDoubleValue()));
+
+        return values;
+    }
+
+    bool parseArguments (const juce::StringArray& args, BenchOptions& options)
+    {
+        for (int i = 0; i < args.size(); ++i)
+        {
+            auto arg = args[i];
+
+            if (arg == "--quick")
+            {
+                options.blockSizes = { 32, 512 };
+                options.sampleRates = { 48000.0 };
+                options.slopes = { 0, 3 };
+                options.channelCounts = { 2 };
+                options.secondsPerRun = 0.25;
+                continue;
+            }
+
+            if (arg == "--parallel")
+            {
+                options.parallel = true;
+                continue;
+            }
+
+            if (arg == "--double")
+            {
+                options.doublePrecision = true;
+                continue;
+            }
+
+            if (arg == "--svf")
+            {
+                options.svf = true;
+                continue;
+            }
+
+            if (! arg.startsWith ("--") || i + 1 >= args.size())
+                return false;
+
+            auto value = args[++i];
+
+            if (arg == "--blocks")          options.blockSizes = parseList<int> (value);
+            else if (arg == "--rates")      options.sampleRates = parseList<double> (value);
+            else if (arg == "--slopes")     options.slopes = parseList<int> (value);
+            else if (arg == "--channels")   options.channelCounts = parseList<int> (value);
+            else if (arg == "--seconds")    options.secondsPerRun = value.getDoubleValue();
+            else if (arg == "--bands")      options.numBands = juce::jlimit (0, maxBands, value.getIntValue());
+            else if (arg == "--out")        options.output = juce::File::getCurrentWorkingDirectory().getChildFile (value);
+            else                            return false;
+        }
+
+        return options.secondsPerRun > 0.0;
+    }
+
+    //==============================================================================
+    class Bench
+    {
+    public:
+        explicit Bench (const BenchOptions& o) : options (o) {}
+
+        juce::var runAll()
+        {
+            juce::Array<juce::var> results;
+
+            for (auto numChannels : options.channelCounts)
+            {
+                if (! VonicTools::setMainBusChannels (processor, numChannels))
+                {
+                    std::cerr << "Skipping unsupported channel count " << numChannels << std::endl;
+                    continue;
+                }
+
+                for (auto sampleRate : options.sampleRates)
+                    for (auto blockSize : options.blockSizes)
+                        for (auto slope : options.slopes)
+                            for (auto automated : { false, true })
+                                results.add (run ({ blockSize, sampleRate, slope, numChannels, automated }));
+            }
+
+            auto* root = new juce::DynamicObject();
+            root->setProperty ("plugin", JucePlugin_Name);
+            root->setProperty ("version", JucePlugin_VersionString);
+           #if JUCE_DEBUG
+            root->setProperty ("build", "Debug");
+           #else
+            root->setProperty ("build", "Release");
+           #endif
+            root->setProperty ("simdLanes", (int) FilterChain<float>::Register::size());
+            root->setProperty ("secondsPerRun", options.secondsPerRun);
+            root->setProperty ("bands", options.numBands);
+            root->setProperty ("structure", options.parallel ? "parallel" : "series");
+            root->setProperty ("precision", options.doublePrecision ? "double" : "single");
+            root->setProperty ("engine", options.svf ? "svf" : "biquad");
+            root->setProperty ("results", results);
+            return juce::var (root);
+        }
+
+    private:
+        void setParameter (const juce::String& id, float value)
+        {
+            auto* param = processor.bleh.getParameter (id);
+            param->setValueNotifyingHost (param->convertTo0to1 (value));
+        }
+
+        void setStaticParameters (int slope)
+        {
+            setParameter ("HighPass", 80.f);
+            setParameter ("LowPass", 12000.f);
+            setParameter ("Peak", 1000.f);
+            setParameter ("Gain", 6.f);
+            setParameter ("Quality", 1.f);
+            setParameter ("HighPassGrad", (float) slope);
+            setParameter ("LowPassGrad", (float) slope);
+            setParameter ("Structure", options.parallel ? 1.f : 0.f);
+            setParameter ("Precision", options.doublePrecision ? 1.f : 0.f);
+            setParameter ("Engine", options.svf ? 1.f : 0.f);
+
+            // Alternating +/-3 dB bells, so none of them is skipped as flat.
+            for (int band = 0; band < maxBands; ++band)
+            {
+                setParameter (BandParameters::getParameterID (band, "Type"), band < options.numBands ? (float) bandPeak : (float) bandOff);
+                setParameter (BandParameters::getParameterID (band, "Gain"), band % 2 == 0 ? 3.f : -3.f);
+            }
+        }
+
+        /** A slow sweep over both cut frequencies and the peak, so every block needs a redesign. */
+        void automate (int blockIndex, int numBlocks)
+        {
+            auto phase = juce::MathConstants<float>::twoPi * (float) blockIndex / (float) juce::jmax (1, numBlocks);
+            auto amount = 0.5f + 0.5f * std::sin (phase);
+
+            setParameter ("HighPass", 40.f + 360.f * amount);
+            setParameter ("LowPass", 6000.f + 10000.f * amount);
+            setParameter ("Peak", 500.f + 4500.f * amount);
+        }
+
+        void fillNoise (juce::AudioBuffer<float>& buffer)
+        {
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                    buffer.setSample (ch, i, random.nextFloat() * 2.f - 1.f);
+        }
+
+        /** Runs the cascade the options picked with fixed coefficients, and returns the ticks spent in process(). */
+        template <typename SampleType>
+        juce::int64 timeChain (const BenchConfig& config, const CoefficientDesigner& designer, const FilterSet& settings,
+                               const juce::AudioBuffer<float>& source, int numBlocks)
+        {
+            auto numLowCut = CoefficientDesigner::getNumSections (settings.lowCutSlope);
+            auto numHighCut = CoefficientDesigner::getNumSections (settings.highCutSlope);
+
+            FilterChain<SampleType> chain;
+            chain.prepare ({ config.sampleRate, (juce::uint32) config.blockSize, (juce::uint32) config.numChannels });
+
+            if (options.svf)
+            {
+                chain.setSvfCoefficients (LowCut, designer.getSvfLowCut().data(), numLowCut, 0);
+                chain.setSvfCoefficients (Peak, &designer.getSvfPeak(), 1, 0);
+                chain.setSvfCoefficients (HighCut, designer.getSvfHighCut().data(), numHighCut, 0);
+            }
+            else
+            {
+                chain.setCoefficients (LowCut, designer.getLowCut().data(), numLowCut);
+                chain.setCoefficients (Peak, &designer.getPeak(), 1);
+                chain.setCoefficients (HighCut, designer.getHighCut().data(), numHighCut);
+            }
+
+            juce::AudioBuffer<SampleType> buffer (config.numChannels, config.blockSize);
+            juce::int64 ticks = 0;
+
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                for (int ch = 0; ch < config.numChannels; ++ch)
+                    for (int i = 0; i < config.blockSize; ++i)
+                        buffer.setSample (ch, i, (SampleType) source.getSample (ch, i));
+
+                juce::dsp::AudioBlock<SampleType> audioBlock (buffer);
+
+                auto start = juce::Time::getHighResolutionTicks();
+                chain.process (juce::dsp::ProcessContextReplacing<SampleType> (audioBlock));
+                ticks += juce::Time::getHighResolutionTicks() - start;
+            }
+
+            return ticks;
+        }
+
+        juce::var run (const BenchConfig& config)
+        {
+            auto numBlocks = juce::jmax (16, (int) (options.secondsPerRun * config.sampleRate / config.blockSize));
+            auto numFrames = (double) numBlocks * config.blockSize;
+
+            juce::AudioBuffer<float> source (config.numChannels, config.blockSize), buffer (config.numChannels, config.blockSize);
+            juce::MidiBuffer midi;
+            fillNoise (source);
+
+            //==============================================================================
+            setStaticParameters (config.slope);
+            processor.setRateAndBufferSizeDetails (config.sampleRate, config.blockSize);
+            processor.prepareToPlay (config.sampleRate, config.blockSize);
+
+            juce::int64 processTicks = 0;
+
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                buffer.makeCopyOf (source, true);
+
+                if (config.automated)
+                    automate (block, numBlocks);
+
+                auto start = juce::Time::getHighResolutionTicks();
+                processor.processBlock (buffer, midi);
+                processTicks += juce::Time::getHighResolutionTicks() - start;
+            }
+
+            // prepareToPlay reset the monitor, so this is just the blocks above.
+            auto monitorStats = processor.getRealtimeMonitor().getStats();
+            processor.releaseResources();
+
+            //==============================================================================
+            // The two halves of processBlock on their own: designing a full set
+            // of coefficients, and running the chain with fixed coefficients.
+            auto settings = getFilterSet (processor.bleh);
+            CoefficientDesigner designer;
+            designer.prepare (config.sampleRate);
+
+            auto designStart = juce::Time::getHighResolutionTicks();
+
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                settings.lowCutFreq = 40.f + (float) (block % 360);
+
+                if (options.svf)
+                    designer.updateSvf (settings, allStages);
+                else
+                    designer.update (settings, allStages);
+            }
+
+            auto designTicks = juce::Time::getHighResolutionTicks() - designStart;
+
+            // The parallel sections redesign on their own thread, so there is
+            // no fixed-coefficient run of them to time on its own.
+            auto filterTicks = options.parallel ? juce::int64 (0)
+                             : options.doublePrecision ? timeChain<double> (config, designer, settings, source, numBlocks)
+                                                       : timeChain<float> (config, designer, settings, source, numBlocks);
+
+            //==============================================================================
+            auto processNs = ticksToNanoseconds (processTicks);
+            auto audioNs = numFrames / config.sampleRate * 1.0e9;
+
+            auto* result = new juce::DynamicObject();
+            result->setProperty ("blockSize", config.blockSize);
+            result->setProperty ("sampleRate", config.sampleRate);
+            result->setProperty ("slope", config.slope);
+            result->setProperty ("channels", config.numChannels);
+            result->setProperty ("automated", config.automated);
+            result->setProperty ("nsPerSample", processNs / numFrames);
+            result->setProperty ("nsPerChannelSample", processNs / (numFrames * config.numChannels));
+            result->setProperty ("realtimePercent", 100.0 * processNs / audioNs);
+            result->setProperty ("designNsPerUpdate", ticksToNanoseconds (designTicks) / numBlocks);
+
+            if (! options.parallel)
+                result->setProperty ("filterNsPerSample", ticksToNanoseconds (filterTicks) / numFrames);
+
+           #if VONIC_RT_CHECKS && JUCE_LINUX
+            // Only counted when the monitor's hooks are built in.
+            auto heapCalls = monitorStats.numViolationsOfKind[RealtimeMonitor::heapAllocation];
+            result->setProperty ("allocationsPerBlock", (double) heapCalls / numBlocks);
+           #else
+            juce::ignoreUnused (monitorStats);
+           #endif
+
+            std::cerr << "." << std::flush;
+            return juce::var (result);
+        }
+
+        const BenchOptions& options;
+        VonicRewriteAudioProcessor processor;
+        juce::Random random { 0x5eed };
+    };
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    BenchOptions options;
+
+    if (! parseArguments (juce::StringArray (argv + 1, argc - 1), options))
+    {
+        printUsage();
+        return 1;
+    }
+
+    Bench bench (options);
+    auto json = juce::JSON::toString (bench.runAll());
+    std::cerr << std::endl;
+
+    if (options.output == juce::File())
+    {
+        std::cout << json << std::endl;
+        return 0;
+    }
+
+    return options.output.replaceWithText (json) ? 0 : 1;
+}
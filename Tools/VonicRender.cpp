@@ -0,0 +1,312 @@
+/*
+  ==============================================================================
+
+    VonicRender.cpp
+    Created: 17 Oct 2026 7:00:33am
+    Author:  vortex
+
+    Headless batch renderer. Streams audio files through the EQ in blocks,
+    one VonicRewriteAudioProcessor per worker thread, no editor and no host.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../Source/PluginProcessor.h"
+#include "ToolHelpers.h"
+
+namespace
+{
+    struct RenderOptions
+    {
+        juce::StringArray parameters;
+        juce::File preset, outputDir;
+        juce::String format;        // empty means "same as the input file"
+        int blockSize = 1024;
+        int numJobs = juce::SystemStats::getNumCpus();
+        bool keepTail = true;
+        juce::Array<juce::File> inputs;
+    };
+
+    juce::CriticalSection logLock;
+
+    void log (const juce::String& message, bool isError = false)
+    {
+        const juce::ScopedLock sl (logLock);
+        (isError ? std::cerr : std::cout) << message << std::endl;
+    }
+
+    void printUsage()
+    {
+        std::cout << "Usage: VonicRender [options] --out <dir> <file>...\n"
+                     "\n"
+                     "  --out <dir>          where rendered files are written (required)\n"
+                     "  --set <id>=<value>   set a parameter, e.g. --set HighPass=80 (repeatable)\n"
+                     "  --preset <file>      apply a preset of <id>=<value> lines before any --set\n"
+                     "  --format <ext>       output format: wav, aiff or flac (default: same as input)\n"
+                     "  --block <samples>    processing block size (default 1024)\n"
+                     "  --jobs <n>           worker threads (default: number of CPUs)\n"
+                     "  --no-tail            stop at the input's length instead of letting the EQ ring out\n"
+                     "\n"
+                     "Output is compensated for the EQ's latency, so it lines up with the input.\n";
+    }
+
+    bool parseArguments (const juce::StringArray& args, RenderOptions& options, juce::String& error)
+    {
+        for (int i = 0; i < args.size(); ++i)
+        {
+            auto arg = args[i];
+            auto hasValue = i + 1 < args.size();
+
+            if (arg == "--help" || arg == "-h")
+                return false;
+
+            if (arg == "--no-tail")
+            {
+                options.keepTail = false;
+                continue;
+            }
+
+            if (arg.startsWith ("--") && ! hasValue)
+            {
+                error = "Missing value for " + arg;
+                return false;
+            }
+
+            if (arg == "--out")             options.outputDir = juce::File::getCurrentWorkingDirectory().getChildFile (args[++i]);
+            else if (arg == "--set")        options.parameters.add (args[++i]);
+            else if (arg == "--preset")     options.preset = juce::File::getCurrentWorkingDirectory().getChildFile (args[++i]);
+            else if (arg == "--format")     options.format = args[++i].trimCharactersAtStart (".").toLowerCase();
+            else if (arg == "--block")      options.blockSize = args[++i].getIntValue();
+            else if (arg == "--jobs")       options.numJobs = args[++i].getIntValue();
+            else if (arg.startsWith ("--"))
+            {
+                error = "Unknown option " + arg;
+                return false;
+            }
+            else
+            {
+                options.inputs.add (juce::File::getCurrentWorkingDirectory().getChildFile (arg));
+            }
+        }
+
+        if (options.outputDir == juce::File())
+            error = "No output directory given";
+        else if (options.inputs.isEmpty())
+            error = "No input files given";
+        else if (options.blockSize <= 0 || options.numJobs <= 0)
+            error = "Block size and job count must be positive";
+
+        return error.isEmpty();
+    }
+
+    //==============================================================================
+    class RenderWorker : public juce::Thread
+    {
+    public:
+        RenderWorker (const RenderOptions& o, juce::AudioFormatManager& f,
+                      std::atomic<int>& next, std::atomic<int>& failed)
+            : juce::Thread ("VonicRender worker"),
+              options (o), formats (f), nextInput (next), numFailed (failed)
+        {
+        }
+
+        /** Called on the main thread, before the worker starts. */
+        bool configure (juce::String& error)
+        {
+            if (options.preset != juce::File() && ! VonicTools::loadPreset (processor.bleh, options.preset, error))
+                return false;
+
+            for (auto& assignment : options.parameters)
+            {
+                if (! VonicTools::setParameter (processor.bleh, assignment))
+                {
+                    error = "Unknown parameter or missing value: " + assignment;
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        void run() override
+        {
+            while (! threadShouldExit())
+            {
+                auto index = nextInput++;
+
+                if (index >= options.inputs.size())
+                    break;
+
+                juce::String error;
+
+                if (renderFile (options.inputs.getReference (index), error))
+                    log ("Rendered " + options.inputs.getReference (index).getFileName());
+                else
+                {
+                    log (options.inputs.getReference (index).getFileName() + ": " + error, true);
+                    ++numFailed;
+                }
+            }
+        }
+
+    private:
+        juce::AudioFormat* getOutputFormat (const juce::File& input) const
+        {
+            return formats.findFormatForFileExtension (options.format.isEmpty() ? input.getFileExtension()
+                                                                                 : "." + options.format);
+        }
+
+        static bool fail (juce::String& error, const juce::String& message)
+        {
+            error = message;
+            return false;
+        }
+
+        static int chooseBitDepth (juce::AudioFormat& format, int preferred)
+        {
+            auto depths = format.getPossibleBitDepths();
+            return depths.contains (preferred) ? preferred : depths.getLast();
+        }
+
+        bool renderFile (const juce::File& input, juce::String& error)
+        {
+            std::unique_ptr<juce::AudioFormatReader> reader (formats.createReaderFor (input));
+
+            if (reader == nullptr)
+                return fail (error, "unreadable or unsupported format");
+
+            auto* format = getOutputFormat (input);
+
+            if (format == nullptr)
+                return fail (error, "no writer for output format");
+
+            auto output = options.outputDir.getChildFile (input.getFileNameWithoutExtension()
+                                                          + format->getFileExtensions()[0]);
+
+            if (output == input)
+                return fail (error, "output would overwrite the input");
+
+            auto numChannels = (int) reader->numChannels;
+            auto sampleRate = reader->sampleRate;
+
+            if (! VonicTools::setMainBusChannels (processor, numChannels))
+                return fail (error, juce::String (numChannels) + " channel layout not supported");
+
+            output.deleteFile();
+            std::unique_ptr<juce::OutputStream> stream (output.createOutputStream());
+
+            if (stream == nullptr)
+                return fail (error, "can't create " + output.getFullPathName());
+
+            std::unique_ptr<juce::AudioFormatWriter> writer (format->createWriterFor (stream.get(), sampleRate,
+                                                                                      (unsigned int) numChannels,
+                                                                                      chooseBitDepth (*format, (int) reader->bitsPerSample),
+                                                                                      reader->metadataValues, 0));
+            if (writer == nullptr)
+                return fail (error, "can't write " + format->getFormatName() + " with this layout");
+
+            stream.release(); // now owned by the writer
+
+            processor.setNonRealtime (true);
+            processor.setRateAndBufferSizeDetails (sampleRate, options.blockSize);
+            processor.prepareToPlay (sampleRate, options.blockSize);
+
+            juce::AudioBuffer<float> buffer (numChannels, options.blockSize);
+            juce::MidiBuffer midi;
+            auto ok = true;
+
+            // The first latency samples out are just the EQ's delay, so they are
+            // dropped, and as much silence again is fed past the end to flush
+            // the last of the input through. The tail lets the filters ring out.
+            auto inputLength = reader->lengthInSamples;
+            auto latency = (juce::int64) processor.getLatencySamples();
+            auto tail = options.keepTail ? (juce::int64) std::ceil (processor.getTailLengthSeconds() * sampleRate) : 0;
+            auto endOfRender = inputLength + tail + latency;
+
+            for (juce::int64 position = 0; ok && position < endOfRender && ! threadShouldExit(); position += options.blockSize)
+            {
+                auto numSamples = (int) juce::jmin ((juce::int64) options.blockSize, endOfRender - position);
+                auto numToRead = (int) juce::jlimit ((juce::int64) 0, (juce::int64) numSamples, inputLength - position);
+
+                buffer.setSize (numChannels, numSamples, false, false, true);
+
+                if (numToRead > 0)
+                    ok = reader->read (&buffer, 0, numToRead, position, true, true);
+
+                if (numToRead < numSamples)
+                    buffer.clear (numToRead, numSamples - numToRead);
+
+                processor.processBlock (buffer, midi);
+
+                auto numToSkip = (int) juce::jlimit ((juce::int64) 0, (juce::int64) numSamples, latency - position);
+                ok = ok && writer->writeFromAudioSampleBuffer (buffer, numToSkip, numSamples - numToSkip);
+            }
+
+            processor.releaseResources();
+
+            if (! ok)
+                error = "read or write failed";
+
+            return ok;
+        }
+
+        const RenderOptions& options;
+        juce::AudioFormatManager& formats;
+        std::atomic<int>& nextInput;
+        std::atomic<int>& numFailed;
+        VonicRewriteAudioProcessor processor;
+    };
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    RenderOptions options;
+    juce::String error;
+
+    if (! parseArguments (juce::StringArray (argv + 1, argc - 1), options, error))
+    {
+        if (error.isNotEmpty())
+            std::cerr << error << "\n\n";
+
+        printUsage();
+        return 1;
+    }
+
+    if (! options.outputDir.createDirectory())
+    {
+        std::cerr << "Can't create " << options.outputDir.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    std::atomic<int> nextInput { 0 }, numFailed { 0 };
+    juce::OwnedArray<RenderWorker> workers;
+
+    for (int i = 0; i < juce::jmin (options.numJobs, options.inputs.size()); ++i)
+    {
+        auto* worker = workers.add (new RenderWorker (options, formats, nextInput, numFailed));
+
+        if (! worker->configure (error))
+        {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+    }
+
+    for (auto* worker : workers)
+        worker->startThread();
+
+    for (auto* worker : workers)
+        worker->waitForThreadToExit (-1);
+
+    log (juce::String (options.inputs.size() - numFailed.load()) + " of "
+         + juce::String (options.inputs.size()) + " files rendered");
+
+    return numFailed.load() == 0 ? 0 : 2;
+}
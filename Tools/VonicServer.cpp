@@ -0,0 +1,758 @@
+/*
+  ==============================================================================
+
+    VonicServer.cpp
+    Created: 17 Oct 2026 7:37:36am
+    Author:  vortex
+
+    Hosts many independent EQ streams in one process, e.g. a few hundred
+    mono feeds on a broadcast box. Every stream is its own
+    VonicRewriteAudioProcessor with its own parameters. Each period, the
+    streams are shared out over a pool of worker threads (optionally pinned
+    to cores), and a worker that runs out steals from the others.
+
+    Input is stand-in audio: a file looped from memory, or noise. Parameters
+    are changed while running through line commands on stdin or a Unix
+    socket. Linux only.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../Source/PluginProcessor.h"
+#include "ToolHelpers.h"
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+    struct ServerOptions
+    {
+        int numStreams = 256;
+        int numChannels = 1;
+        int blockSize = 256;
+        int numThreads = juce::SystemStats::getNumCpus();
+        double sampleRate = 48000.0;
+        double seconds = 0.0;           // 0 runs until "quit"
+        bool pinThreads = false, freeRun = false;
+        juce::File input, preset;
+        juce::String socketPath;        // empty means commands come from stdin
+    };
+
+    void printUsage()
+    {
+        std::cout << "Usage: VonicServer [options]\n"
+                     "\n"
+                     "  --streams <n>        number of independent EQ streams (default 256)\n"
+                     "  --channels <n>       channels per stream (default 1)\n"
+                     "  --rate <hz>          sample rate (default 48000)\n"
+                     "  --block <samples>    period size (default 256)\n"
+                     "  --threads <n>        worker threads (default: number of CPUs)\n"
+                     "  --pin                pin worker n to core n\n"
+                     "  --input <file>       loop this file as every stream's input (default: noise)\n"
+                     "  --preset <file>      apply a preset of <id>=<value> lines to every stream\n"
+                     "  --socket <path>      take commands on a Unix socket instead of stdin\n"
+                     "  --seconds <s>        stop after this long (default: run until \"quit\")\n"
+                     "  --freerun            don't wait for the clock; run periods back to back\n"
+                     "\n"
+                     "Commands, one per line:\n"
+                     "  set <streams> <id>=<value> ...   e.g. set 0-63 HighPass=80 Gain=-3\n"
+                     "  preset <streams> <file>\n"
+                     "  get <stream> <id>\n"
+                     "  stats\n"
+                     "  quit\n"
+                     "<streams> is \"all\", an index, a range a-b, or a comma separated list of those.\n"
+                     "Parameters that can't be automated (PhaseMode, Structure, Oversampling, Threading, ...)\n"
+                     "only take effect when the streams start, so they go in --preset.\n";
+    }
+
+    bool parseArguments (const juce::StringArray& args, ServerOptions& options, juce::String& error)
+    {
+        for (int i = 0; i < args.size(); ++i)
+        {
+            auto arg = args[i];
+
+            if (arg == "--help" || arg == "-h")
+                return false;
+
+            if (arg == "--pin")         { options.pinThreads = true; continue; }
+            if (arg == "--freerun")     { options.freeRun = true; continue; }
+
+            if (arg.startsWith ("--") && i + 1 >= args.size())
+            {
+                error = "Missing value for " + arg;
+                return false;
+            }
+
+            if (arg == "--streams")         options.numStreams = args[++i].getIntValue();
+            else if (arg == "--channels")   options.numChannels = args[++i].getIntValue();
+            else if (arg == "--rate")       options.sampleRate = args[++i].getDoubleValue();
+            else if (arg == "--block")      options.blockSize = args[++i].getIntValue();
+            else if (arg == "--threads")    options.numThreads = args[++i].getIntValue();
+            else if (arg == "--input")      options.input = juce::File::getCurrentWorkingDirectory().getChildFile (args[++i]);
+            else if (arg == "--preset")     options.preset = juce::File::getCurrentWorkingDirectory().getChildFile (args[++i]);
+            else if (arg == "--socket")     options.socketPath = args[++i];
+            else if (arg == "--seconds")    options.seconds = args[++i].getDoubleValue();
+            else
+            {
+                error = "Unknown option " + arg;
+                return false;
+            }
+        }
+
+        if (options.numStreams <= 0 || options.numChannels <= 0 || options.blockSize <= 0
+            || options.numThreads <= 0 || options.sampleRate <= 0.0)
+            error = "Stream, channel, block, thread counts and the rate must be positive";
+
+        return error.isEmpty();
+    }
+
+    /** Parses "all", "7", "0-63" or "1,4,10-12" into stream indices. */
+    bool parseStreamList (const juce::String& text, int numStreams, juce::Array<int>& indices)
+    {
+        if (text == "all")
+        {
+            for (int i = 0; i < numStreams; ++i)
+                indices.add (i);
+
+            return true;
+        }
+
+        for (auto& token : juce::StringArray::fromTokens (text, ",", {}))
+        {
+            auto first = token.upToFirstOccurrenceOf ("-", false, false).getIntValue();
+            auto last = token.contains ("-") ? token.fromFirstOccurrenceOf ("-", false, false).getIntValue() : first;
+
+            if (! token.containsOnly ("0123456789-") || first < 0 || last >= numStreams || first > last)
+                return false;
+
+            for (int i = first; i <= last; ++i)
+                indices.addIfNotAlreadyThere (i);
+        }
+
+        return ! indices.isEmpty();
+    }
+
+    //==============================================================================
+    /** Stand-in input: a file read into memory, or a few seconds of noise.
+        Streams read it at different offsets, so they aren't all identical. */
+    class SourceAudio
+    {
+    public:
+        bool load (const ServerOptions& options, juce::String& error)
+        {
+            if (options.input == juce::File())
+            {
+                juce::Random random { 0x5eed };
+                audio.setSize (1, (int) (options.sampleRate * 10.0));
+
+                for (int i = 0; i < audio.getNumSamples(); ++i)
+                    audio.setSample (0, i, (random.nextFloat() * 2.f - 1.f) * 0.25f);
+
+                return true;
+            }
+
+            juce::AudioFormatManager formats;
+            formats.registerBasicFormats();
+            std::unique_ptr<juce::AudioFormatReader> reader (formats.createReaderFor (options.input));
+
+            if (reader == nullptr || reader->lengthInSamples <= 0)
+            {
+                error = "Can't read " + options.input.getFullPathName();
+                return false;
+            }
+
+            // Capped at a minute; it is only there to give the filters something to chew on.
+            auto length = (int) juce::jmin (reader->lengthInSamples, (juce::int64) (reader->sampleRate * 60.0));
+            audio.setSize ((int) reader->numChannels, length);
+            reader->read (&audio, 0, length, 0, true, true);
+            return true;
+        }
+
+        void fill (juce::AudioBuffer<float>& dest, juce::int64 position) const noexcept
+        {
+            auto length = audio.getNumSamples();
+
+            for (int ch = 0; ch < dest.getNumChannels(); ++ch)
+            {
+                auto* src = audio.getReadPointer (ch % audio.getNumChannels());
+                auto* out = dest.getWritePointer (ch);
+                auto index = (int) (position % length);
+
+                for (int i = 0; i < dest.getNumSamples(); ++i)
+                {
+                    out[i] = src[index];
+                    index = index + 1 < length ? index + 1 : 0;
+                }
+            }
+        }
+
+        int getLength() const noexcept     { return audio.getNumSamples(); }
+
+    private:
+        juce::AudioBuffer<float> audio;
+    };
+
+    //==============================================================================
+    struct Stream
+    {
+        VonicRewriteAudioProcessor processor;
+        juce::AudioBuffer<float> buffer;
+        juce::MidiBuffer midi;
+        juce::int64 position = 0;
+        std::atomic<float> peak { 0.f };    // output peak since the last "stats"
+    };
+
+    //==============================================================================
+    /**
+        One worker's share of a period: a range of stream indices. The owner
+        takes from the front and thieves take from the back. Both ends live in
+        one atomic word, so either is a single compare-and-swap, and nothing
+        ever blocks. Padded to a cache line so neighbours don't share one.
+    */
+    struct alignas (64) StealableRange
+    {
+        void assign (juce::uint32 begin, juce::uint32 end) noexcept
+        {
+            bounds.store (pack (begin, end), std::memory_order_release);
+        }
+
+        bool take (int& index, bool fromBack) noexcept
+        {
+            auto current = bounds.load (std::memory_order_acquire);
+
+            for (;;)
+            {
+                auto front = (juce::uint32) (current >> 32);
+                auto back = (juce::uint32) current;
+
+                if (front >= back)
+                    return false;
+
+                auto next = fromBack ? pack (front, back - 1) : pack (front + 1, back);
+
+                if (bounds.compare_exchange_weak (current, next, std::memory_order_acq_rel, std::memory_order_acquire))
+                {
+                    index = (int) (fromBack ? back - 1 : front);
+                    return true;
+                }
+            }
+        }
+
+    private:
+        static juce::uint64 pack (juce::uint32 front, juce::uint32 back) noexcept
+        {
+            return ((juce::uint64) front << 32) | back;
+        }
+
+        std::atomic<juce::uint64> bounds { 0 };
+    };
+
+    //==============================================================================
+    /**
+        Runs one job per stream each period. Streams are split into contiguous
+        ranges, one per worker, and keep the same worker from period to period
+        while the load is even, so their state stays in that core's cache.
+    */
+    class StreamPool
+    {
+    public:
+        StreamPool (int numWorkers, bool pinToCores, std::function<void (int)> jobToRun)
+            : job (std::move (jobToRun)), ranges ((size_t) numWorkers)
+        {
+            for (int i = 0; i < numWorkers; ++i)
+                workers.add (new Worker (*this, i, pinToCores));
+
+            for (auto* worker : workers)
+                worker->startThread (juce::Thread::Priority::highest);
+        }
+
+        ~StreamPool()
+        {
+            for (auto* worker : workers)
+                worker->signalThreadShouldExit();
+
+            for (auto* worker : workers)
+            {
+                worker->wake.signal();
+                worker->stopThread (2000);
+            }
+        }
+
+        /** Runs job (0 .. numJobs - 1) across the pool and returns when every one has finished. */
+        void runPeriod (int numJobs)
+        {
+            auto numWorkers = (juce::uint32) workers.size();
+
+            for (juce::uint32 i = 0; i < numWorkers; ++i)
+                ranges[i].assign ((juce::uint32) numJobs * i / numWorkers, (juce::uint32) numJobs * (i + 1) / numWorkers);
+
+            remaining.store (workers.size(), std::memory_order_release);
+
+            for (auto* worker : workers)
+                worker->wake.signal();
+
+            finished.wait (-1);
+        }
+
+        juce::int64 getNumStolen() const noexcept  { return numStolen.load (std::memory_order_relaxed); }
+
+    private:
+        struct Worker  : public juce::Thread
+        {
+            Worker (StreamPool& p, int i, bool pin)
+                : juce::Thread ("VonicServer worker " + juce::String (i)), pool (p), index (i), pinToCore (pin)
+            {
+            }
+
+            void run() override
+            {
+                if (pinToCore)
+                    setCurrentThreadAffinityMask ((juce::uint32) 1 << (index % 32));
+
+                for (;;)
+                {
+                    wake.wait (-1);
+
+                    if (threadShouldExit())
+                        return;
+
+                    pool.drain (index);
+                }
+            }
+
+            StreamPool& pool;
+            const int index;
+            const bool pinToCore;
+            juce::WaitableEvent wake;
+        };
+
+        void drain (int self)
+        {
+            int jobIndex;
+            auto numWorkers = workers.size();
+
+            while (ranges[(size_t) self].take (jobIndex, false))
+                job (jobIndex);
+
+            // Out of our own; go round the others, nearest first, taking from the back.
+            for (int offset = 1; offset < numWorkers; ++offset)
+            {
+                auto& victim = ranges[(size_t) ((self + offset) % numWorkers)];
+
+                while (victim.take (jobIndex, true))
+                {
+                    numStolen.fetch_add (1, std::memory_order_relaxed);
+                    job (jobIndex);
+                }
+            }
+
+            // Everything has been handed out and our jobs are done; the last one out ends the period.
+            if (remaining.fetch_sub (1, std::memory_order_acq_rel) == 1)
+                finished.signal();
+        }
+
+        std::function<void (int)> job;
+        std::vector<StealableRange> ranges;
+        juce::OwnedArray<Worker> workers;
+        std::atomic<int> remaining { 0 };
+        std::atomic<juce::int64> numStolen { 0 };
+        juce::WaitableEvent finished;
+    };
+
+    //==============================================================================
+    class Server
+    {
+    public:
+        explicit Server (const ServerOptions& o) : options (o) {}
+
+        bool prepare (juce::String& error)
+        {
+            if (! source.load (options, error))
+                return false;
+
+            for (int i = 0; i < options.numStreams; ++i)
+            {
+                auto* stream = streams.add (new Stream());
+
+                if (! VonicTools::setMainBusChannels (stream->processor, options.numChannels))
+                {
+                    error = juce::String (options.numChannels) + " channel layout not supported";
+                    return false;
+                }
+
+                if (options.preset != juce::File() && ! VonicTools::loadPreset (stream->processor.bleh, options.preset, error))
+                    return false;
+
+                stream->buffer.setSize (options.numChannels, options.blockSize);
+                stream->position = (juce::int64) i * 7919 % juce::jmax (1, source.getLength());
+                stream->processor.setRateAndBufferSizeDetails (options.sampleRate, options.blockSize);
+                stream->processor.prepareToPlay (options.sampleRate, options.blockSize);
+            }
+
+            pool = std::make_unique<StreamPool> (juce::jmin (options.numThreads, options.numStreams), options.pinThreads,
+                                                 [this] (int index) { processStream (index); });
+            return true;
+        }
+
+        void release()
+        {
+            pool.reset();
+
+            for (auto* stream : streams)
+                stream->processor.releaseResources();
+        }
+
+        /** Runs periods until "quit", or the time limit. */
+        void run()
+        {
+            const auto periodSeconds = options.blockSize / options.sampleRate;
+            const auto periodTicks = juce::Time::secondsToHighResolutionTicks (periodSeconds);
+            const auto periodsPerReport = juce::jmax (1, juce::roundToInt (1.0 / periodSeconds));
+            const auto totalPeriods = options.seconds > 0.0 ? (juce::int64) std::ceil (options.seconds / periodSeconds) : -1;
+
+            auto deadline = juce::Time::getHighResolutionTicks();
+
+            for (juce::int64 period = 0; ! shouldQuit.load() && period != totalPeriods; ++period)
+            {
+                auto start = juce::Time::getHighResolutionTicks();
+                pool->runPeriod (streams.size());
+                auto elapsed = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start);
+
+                recordPeriod (elapsed / periodSeconds);
+
+                if ((period + 1) % periodsPerReport == 0)
+                    std::cerr << describeStats (false) << std::endl;
+
+                if (options.freeRun)
+                    continue;
+
+                // Keep to the clock, but don't try to catch up after an overrun.
+                deadline = juce::jmax (deadline + periodTicks, juce::Time::getHighResolutionTicks());
+
+                while (juce::Time::getHighResolutionTicks() < deadline)
+                    juce::Thread::sleep (juce::jmax (0, (int) (juce::Time::highResolutionTicksToSeconds (deadline - juce::Time::getHighResolutionTicks()) * 1000.0) - 1));
+            }
+        }
+
+        /** Called from the control thread. Returns the reply, without a trailing newline. */
+        juce::String handleCommand (const juce::String& line)
+        {
+            auto tokens = juce::StringArray::fromTokens (line, true);
+
+            if (tokens.isEmpty())
+                return {};
+
+            auto command = tokens[0];
+
+            if (command == "quit")
+            {
+                shouldQuit = true;
+                return "ok";
+            }
+
+            if (command == "stats")
+                return describeStats (true);
+
+            if (command == "help")
+                return "set <streams> <id>=<value> ... | preset <streams> <file> | get <stream> <id> | stats | quit";
+
+            juce::Array<int> indices;
+
+            if (tokens.size() < 3 || ! parseStreamList (tokens[1], streams.size(), indices))
+                return "error: expected <command> <streams> ...";
+
+            if (command == "set" || command == "preset")
+            {
+                juce::StringArray assignments;
+                juce::String error;
+
+                if (command == "set")
+                    assignments.addArray (tokens, 2);
+                else if (! VonicTools::readPreset (juce::File::getCurrentWorkingDirectory().getChildFile (tokens[2]), assignments, error))
+                    return "error: " + error;
+
+                if (! checkLiveAssignments (assignments, error))
+                    return "error: " + error;
+
+                // Parameters are plain atomics underneath, so they can be set
+                // from here while the workers are mid-period.
+                for (auto& assignment : assignments)
+                    for (auto index : indices)
+                        VonicTools::setParameter (streams[index]->processor.bleh, assignment);
+
+                return "ok " + juce::String (indices.size());
+            }
+
+            if (command == "get")
+            {
+                auto* param = streams[indices.getFirst()]->processor.bleh.getParameter (tokens[2]);
+
+                if (param == nullptr)
+                    return "error: unknown parameter " + tokens[2];
+
+                return juce::String (param->convertFrom0to1 (param->getValue()));
+            }
+
+            return "error: unknown command " + command;
+        }
+
+    private:
+        /** A non-automatable parameter is only followed up in the processor's
+            handleAsyncUpdate, and nothing runs a message loop here to deliver
+            it. Those are refused rather than left half applied.
+        */
+        bool checkLiveAssignments (const juce::StringArray& assignments, juce::String& error)
+        {
+            for (auto& assignment : assignments)
+            {
+                juce::String value;
+                auto* param = VonicTools::findParameter (streams.getFirst()->processor.bleh, assignment, value);
+
+                if (param == nullptr)
+                    error = "unknown parameter or missing value: " + assignment;
+                else if (! param->isAutomatable())
+                    error = param->paramID + " can't be changed while running; set it with --preset";
+                else
+                    continue;
+
+                return false;
+            }
+
+            return true;
+        }
+
+        void processStream (int index) noexcept
+        {
+            auto& stream = *streams.getUnchecked (index);
+
+            source.fill (stream.buffer, stream.position);
+            stream.position += options.blockSize;
+            stream.processor.processBlock (stream.buffer, stream.midi);
+
+            auto level = stream.buffer.getMagnitude (0, options.blockSize);
+
+            if (level > stream.peak.load (std::memory_order_relaxed))
+                stream.peak.store (level, std::memory_order_relaxed);
+        }
+
+        void recordPeriod (double load)
+        {
+            const juce::ScopedLock sl (statsLock);
+            ++numPeriods;
+            totalLoad += load;
+            maxLoad = juce::jmax (maxLoad, load);
+
+            if (load > 1.0)
+                ++numOverruns;
+        }
+
+        /** Load is period processing time over the period length; above 100% is an overrun. */
+        juce::String describeStats (bool includePeak)
+        {
+            const juce::ScopedLock sl (statsLock);
+            juce::String text;
+
+            text << "periods " << numPeriods
+                 << "  load mean " << juce::String (numPeriods > 0 ? 100.0 * totalLoad / (double) numPeriods : 0.0, 1) << "%"
+                 << " max " << juce::String (100.0 * maxLoad, 1) << "%"
+                 << "  overruns " << numOverruns
+                 << "  stolen " << pool->getNumStolen();
+
+            if (includePeak)
+            {
+                auto peak = 0.f;
+
+                for (auto* stream : streams)
+                    peak = juce::jmax (peak, stream->peak.exchange (0.f));
+
+                text << "  peak " << juce::String (juce::Decibels::gainToDecibels (peak), 1) << " dBFS";
+            }
+
+            return text;
+        }
+
+        const ServerOptions& options;
+        SourceAudio source;
+        juce::OwnedArray<Stream> streams;
+        std::unique_ptr<StreamPool> pool;
+        std::atomic<bool> shouldQuit { false };
+
+        juce::CriticalSection statsLock;
+        juce::int64 numPeriods = 0, numOverruns = 0;
+        double totalLoad = 0.0, maxLoad = 0.0;
+    };
+
+    //==============================================================================
+    /**
+        Reads commands a line at a time, from stdin or from clients of a Unix
+        socket (one at a time), and writes each reply back on the same line
+        stream. Everything polls with a timeout, so the thread can be stopped.
+    */
+    class ControlChannel  : public juce::Thread
+    {
+    public:
+        ControlChannel (Server& s, const juce::String& path)
+            : juce::Thread ("VonicServer control"), server (s), socketPath (path)
+        {
+        }
+
+        ~ControlChannel() override
+        {
+            stopThread (2000);
+
+            if (listener >= 0)
+            {
+                ::close (listener);
+                ::unlink (socketPath.toRawUTF8());
+            }
+        }
+
+        bool open (juce::String& error)
+        {
+            if (socketPath.isEmpty())
+                return true;
+
+            sockaddr_un address {};
+            address.sun_family = AF_UNIX;
+
+            if ((size_t) socketPath.getNumBytesAsUTF8() >= sizeof (address.sun_path))
+            {
+                error = "Socket path too long";
+                return false;
+            }
+
+            socketPath.copyToUTF8 (address.sun_path, sizeof (address.sun_path));
+            ::unlink (address.sun_path);
+
+            listener = ::socket (AF_UNIX, SOCK_STREAM, 0);
+
+            if (listener < 0 || ::bind (listener, (sockaddr*) &address, sizeof (address)) != 0 || ::listen (listener, 4) != 0)
+            {
+                error = "Can't listen on " + socketPath;
+                return false;
+            }
+
+            return true;
+        }
+
+        void run() override
+        {
+            if (listener < 0)
+            {
+                serve (STDIN_FILENO, STDOUT_FILENO);
+                return;
+            }
+
+            while (! threadShouldExit())
+            {
+                if (! waitForInput (listener))
+                    continue;
+
+                auto client = ::accept (listener, nullptr, nullptr);
+
+                if (client >= 0)
+                {
+                    serve (client, client);
+                    ::close (client);
+                }
+            }
+        }
+
+    private:
+        bool waitForInput (int fd)
+        {
+            pollfd p { fd, POLLIN, 0 };
+            return ::poll (&p, 1, 200) > 0;
+        }
+
+        /** Handles lines from in until it closes or the thread is stopped. */
+        void serve (int in, int out)
+        {
+            juce::MemoryBlock pending;
+            char chunk[1024];
+
+            while (! threadShouldExit())
+            {
+                if (! waitForInput (in))
+                    continue;
+
+                auto numRead = ::read (in, chunk, sizeof (chunk));
+
+                if (numRead <= 0)
+                    return;
+
+                pending.append (chunk, (size_t) numRead);
+
+                for (;;)
+                {
+                    auto text = pending.toString();
+                    auto newline = text.indexOfChar ('\n');
+
+                    if (newline < 0)
+                        break;
+
+                    auto reply = server.handleCommand (text.substring (0, newline).trim());
+                    pending.removeSection (0, (size_t) text.substring (0, newline + 1).getNumBytesAsUTF8());
+
+                    if (reply.isNotEmpty())
+                    {
+                        reply << "\n";
+                        juce::ignoreUnused (::write (out, reply.toRawUTF8(), reply.getNumBytesAsUTF8()));
+                    }
+                }
+            }
+        }
+
+        Server& server;
+        juce::String socketPath;
+        int listener = -1;
+    };
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    ServerOptions options;
+    juce::String error;
+
+    if (! parseArguments (juce::StringArray (argv + 1, argc - 1), options, error))
+    {
+        if (error.isNotEmpty())
+            std::cerr << error << "\n\n";
+
+        printUsage();
+        return 1;
+    }
+
+    Server server (options);
+
+    if (! server.prepare (error))
+    {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    ControlChannel control (server, options.socketPath);
+
+    if (! control.open (error))
+    {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    std::cerr << options.numStreams << " streams of " << options.numChannels << " channel(s) at "
+              << options.sampleRate << " Hz, " << options.blockSize << " sample periods, "
+              << juce::jmin (options.numThreads, options.numStreams) << " workers" << std::endl;
+
+    control.startThread();
+    server.run();
+    control.stopThread (2000);
+    server.release();
+    return 0;
+}